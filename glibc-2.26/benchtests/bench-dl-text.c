@@ -0,0 +1,151 @@
+/* Benchmark calls spread over the text of a large shared object.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* The object is loaded with dlopen, so that the dynamic linker maps its
+   text according to the glibc.rtld.hugepage_text tunable, which is set
+   by the bench-dl target.  Where the kernel provides a counter for
+   them, the iTLB misses during the measurement are reported too.  */
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+#endif
+
+#include "bench-timing.h"
+#include "json-lib.h"
+
+/* Number of walks over all functions of the object.  */
+#define WALKS 2000
+
+static int
+open_itlb_counter (void)
+{
+#if defined __linux__ && defined __NR_perf_event_open
+  struct perf_event_attr attr;
+  memset (&attr, 0, sizeof (attr));
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.size = sizeof (attr);
+  attr.config = (PERF_COUNT_HW_CACHE_ITLB
+		 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+		 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  return -1;
+#endif
+}
+
+static void
+usage (const char *name)
+{
+  fprintf (stderr, "%s: <shared object>\n", name);
+  exit (1);
+}
+
+int
+main (int argc, char **argv)
+{
+  if (argc != 2)
+    usage (argv[0]);
+
+  void *handle = dlopen (argv[1], RTLD_NOW);
+  if (handle == NULL)
+    {
+      fprintf (stderr, "dlopen: %s\n", dlerror ());
+      return 1;
+    }
+  unsigned int (*walk) (unsigned int) = dlsym (handle, "bench_text_walk");
+  unsigned int (*functions) (void) = dlsym (handle, "bench_text_functions");
+  if (walk == NULL || functions == NULL)
+    {
+      fprintf (stderr, "dlsym: %s\n", dlerror ());
+      return 1;
+    }
+
+  timing_t res;
+  TIMING_INIT (res);
+  (void) res;
+
+  /* Fault in the text before measuring.  */
+  unsigned int x = walk (1);
+
+  int counter = open_itlb_counter ();
+  long long int misses = -1;
+
+#ifdef __linux__
+  if (counter >= 0)
+    {
+      ioctl (counter, PERF_EVENT_IOC_RESET, 0);
+      ioctl (counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+
+  timing_t start, stop, elapsed;
+  TIMING_NOW (start);
+  for (int i = 0; i < WALKS; ++i)
+    x = walk (x);
+  TIMING_NOW (stop);
+  TIMING_DIFF (elapsed, start, stop);
+
+#ifdef __linux__
+  if (counter >= 0)
+    {
+      ioctl (counter, PERF_EVENT_IOC_DISABLE, 0);
+      if (read (counter, &misses, sizeof (misses)) != sizeof (misses))
+	misses = -1;
+      close (counter);
+    }
+#endif
+
+  double calls = (double) WALKS * functions ();
+
+  json_ctx_t json_ctx;
+  json_init (&json_ctx, 0, stdout);
+  json_document_begin (&json_ctx);
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+  json_attr_object_begin (&json_ctx, "functions");
+  json_attr_object_begin (&json_ctx, "dl_text");
+  json_attr_object_begin (&json_ctx, "");
+
+  json_attr_double (&json_ctx, "duration", (double) elapsed);
+  json_attr_double (&json_ctx, "iterations", calls);
+  json_attr_double (&json_ctx, "time_per_call", (double) elapsed / calls);
+  if (misses >= 0)
+    {
+      json_attr_double (&json_ctx, "itlb_misses", (double) misses);
+      json_attr_double (&json_ctx, "itlb_misses_per_call", misses / calls);
+    }
+  /* Keep the result of the calls alive.  */
+  json_attr_uint (&json_ctx, "checksum", x);
+
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+  json_document_end (&json_ctx);
+
+  dlclose (handle);
+  return 0;
+}
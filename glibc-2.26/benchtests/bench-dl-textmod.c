@@ -0,0 +1,88 @@
+/* Object with a large text segment for bench-dl-text.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* 4096 small functions, each on its own 4 KiB page, for 17 MiB of
+   text.  Calling them in a scattered order needs a different iTLB
+   entry for each call unless the text is backed by huge pages.  The
+   functions are separated by padding which is slightly larger than a
+   page, so that they do not all compete for the same cache sets.  The
+   module is compiled with -fno-toplevel-reorder to keep this layout.  */
+
+#define PAGE_FUNCTION(n)						\
+  static unsigned int __attribute__ ((noinline, aligned (64)))		\
+  f##n (unsigned int x)							\
+  {									\
+    return x * 33 + 0x##n;						\
+  }									\
+  static void __attribute__ ((used, noinline, aligned (64)))		\
+  pad##n (void)								\
+  {									\
+    asm volatile (".skip 4096");					\
+  }
+
+#define FUNCTIONS16(p)							\
+  PAGE_FUNCTION (p##0) PAGE_FUNCTION (p##1) PAGE_FUNCTION (p##2)	\
+  PAGE_FUNCTION (p##3) PAGE_FUNCTION (p##4) PAGE_FUNCTION (p##5)	\
+  PAGE_FUNCTION (p##6) PAGE_FUNCTION (p##7) PAGE_FUNCTION (p##8)	\
+  PAGE_FUNCTION (p##9) PAGE_FUNCTION (p##a) PAGE_FUNCTION (p##b)	\
+  PAGE_FUNCTION (p##c) PAGE_FUNCTION (p##d) PAGE_FUNCTION (p##e)	\
+  PAGE_FUNCTION (p##f)
+#define FUNCTIONS256(p)							\
+  FUNCTIONS16 (p##0) FUNCTIONS16 (p##1) FUNCTIONS16 (p##2)		\
+  FUNCTIONS16 (p##3) FUNCTIONS16 (p##4) FUNCTIONS16 (p##5)		\
+  FUNCTIONS16 (p##6) FUNCTIONS16 (p##7) FUNCTIONS16 (p##8)		\
+  FUNCTIONS16 (p##9) FUNCTIONS16 (p##a) FUNCTIONS16 (p##b)		\
+  FUNCTIONS16 (p##c) FUNCTIONS16 (p##d) FUNCTIONS16 (p##e)		\
+  FUNCTIONS16 (p##f)
+
+FUNCTIONS256 (0) FUNCTIONS256 (1) FUNCTIONS256 (2) FUNCTIONS256 (3)
+FUNCTIONS256 (4) FUNCTIONS256 (5) FUNCTIONS256 (6) FUNCTIONS256 (7)
+FUNCTIONS256 (8) FUNCTIONS256 (9) FUNCTIONS256 (a) FUNCTIONS256 (b)
+FUNCTIONS256 (c) FUNCTIONS256 (d) FUNCTIONS256 (e) FUNCTIONS256 (f)
+
+#undef PAGE_FUNCTION
+#define PAGE_FUNCTION(n) f##n,
+
+static unsigned int (*const functions[]) (unsigned int) =
+  {
+    FUNCTIONS256 (0) FUNCTIONS256 (1) FUNCTIONS256 (2) FUNCTIONS256 (3)
+    FUNCTIONS256 (4) FUNCTIONS256 (5) FUNCTIONS256 (6) FUNCTIONS256 (7)
+    FUNCTIONS256 (8) FUNCTIONS256 (9) FUNCTIONS256 (a) FUNCTIONS256 (b)
+    FUNCTIONS256 (c) FUNCTIONS256 (d) FUNCTIONS256 (e) FUNCTIONS256 (f)
+  };
+
+#define NFUNCTIONS (sizeof (functions) / sizeof (functions[0]))
+
+/* Call each function once, in an order which defeats prefetching.  */
+unsigned int
+bench_text_walk (unsigned int x)
+{
+  unsigned int i = 0;
+  for (unsigned int n = 0; n < NFUNCTIONS; ++n)
+    {
+      x = functions[i] (x);
+      i = (i + 1021) % NFUNCTIONS;
+    }
+  return x;
+}
+
+unsigned int
+bench_text_functions (void)
+{
+  return NFUNCTIONS;
+}
@@ -19,6 +19,8 @@
 #define TEST_MAIN
 #ifdef WIDE
 # define TEST_NAME "wmemcmp"
+#elif defined TEST_MEMCMPEQ
+# define TEST_NAME "__memcmpeq"
 #else
 # define TEST_NAME "memcmp"
 #endif
@@ -49,7 +51,11 @@ simple_wmemcmp (const wchar_t *s1, const wchar_t *s2, size_t n)
 #else
 # include <limits.h>
 
-# define MEMCMP memcmp
+# ifdef TEST_MEMCMPEQ
+#  define MEMCMP __memcmpeq
+# else
+#  define MEMCMP memcmp
+# endif
 # define MEMCPY memcpy
 # define SIMPLE_MEMCMP simple_memcmp
 # define CHAR char
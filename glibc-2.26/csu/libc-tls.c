@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <sys/param.h>
+#include <rseq-internal.h>
 
 
 #ifdef SHARED
@@ -58,6 +59,9 @@ size_t _dl_tls_static_size = 2048;
 size_t _dl_tls_static_used;
 /* Alignment requirement of the static TLS block.  */
 size_t _dl_tls_static_align;
+/* The surplus of a statically linked program is only used for modules
+   which need static TLS.  */
+size_t _dl_tls_static_optional;
 
 /* Generation counter for the dtv.  */
 size_t _dl_tls_generation;
@@ -195,6 +199,9 @@ __libc_setup_tls (void)
   if (__builtin_expect (lossage != NULL, 0))
     __libc_fatal (lossage);
 
+  /* Register the rseq area of the initial thread.  */
+  _dl_rseq_init ();
+
   /* Update the executable's link map with enough information to make
      the TLS routines happy.  */
   main_map->l_tls_align = align;
@@ -35,7 +35,7 @@ __dladdr (const void *address, Dl_info *info)
   if (__glibc_unlikely (_dlfcn_hook != NULL))
     return _dlfcn_hook->dladdr (address, info);
 # endif
-  return _dl_addr (address, info, NULL, NULL);
+  return _dl_addr_index (address, info, NULL, NULL);
 }
 # ifdef SHARED
 strong_alias (__dladdr, dladdr)
@@ -40,11 +40,11 @@ __dladdr1 (const void *address, Dl_info *info, void **extra, int flags)
     {
     default:			/* Make this an error?  */
     case 0:
-      return _dl_addr (address, info, NULL, NULL);
+      return _dl_addr_index (address, info, NULL, NULL);
     case RTLD_DL_SYMENT:
-      return _dl_addr (address, info, NULL, (const ElfW(Sym) **) extra);
+      return _dl_addr_index (address, info, NULL, (const ElfW(Sym) **) extra);
     case RTLD_DL_LINKMAP:
-      return _dl_addr (address, info, (struct link_map **) extra, NULL);
+      return _dl_addr_index (address, info, (struct link_map **) extra, NULL);
     }
 }
 # ifdef SHARED
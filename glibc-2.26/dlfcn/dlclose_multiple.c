@@ -0,0 +1,65 @@
+/* Close several dynamic shared objects at once.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <ldsodefs.h>
+
+#if !defined SHARED && IS_IN (libdl)
+
+int
+dlclose_multiple (void *const *handles, size_t count, int flags)
+{
+  return __dlclose_multiple (handles, count, flags);
+}
+
+#else
+
+struct dlclose_multiple_args
+{
+  void *const *handles;
+  size_t count;
+  int flags;
+};
+
+static void
+dlclose_multiple_doit (void *a)
+{
+  struct dlclose_multiple_args *args = a;
+
+  GLRO(dl_close_multiple) (args->handles, args->count, args->flags);
+}
+
+int
+__dlclose_multiple (void *const *handles, size_t count, int flags)
+{
+# ifdef SHARED
+  if (__glibc_unlikely (_dlfcn_hook != NULL))
+    return _dlfcn_hook->dlclose_multiple (handles, count, flags);
+# endif
+
+  struct dlclose_multiple_args args;
+  args.handles = handles;
+  args.count = count;
+  args.flags = flags;
+
+  return _dlerror_run (dlclose_multiple_doit, &args) ? -1 : 0;
+}
+# ifdef SHARED
+strong_alias (__dlclose_multiple, dlclose_multiple)
+# endif
+#endif
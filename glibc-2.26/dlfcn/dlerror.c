@@ -238,7 +238,8 @@ static struct dlfcn_hook _dlfcn_hooks =
     .dladdr = __dladdr,
     .dladdr1 = __dladdr1,
     .dlinfo = __dlinfo,
-    .dlmopen = __dlmopen
+    .dlmopen = __dlmopen,
+    .dlclose_multiple = __dlclose_multiple
   };
 
 void
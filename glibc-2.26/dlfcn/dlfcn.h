@@ -74,6 +74,16 @@ extern void *dlvsym (void *__restrict __handle,
 		     const char *__restrict __name,
 		     const char *__restrict __version)
      __THROW __nonnull ((2, 3));
+
+/* Close the COUNT objects in HANDLES as if by calling `dlclose' on each
+   of them, but unload everything which is no longer used in one pass.
+   If FLAGS contains DLCLOSE_DEFER, unloading is postponed until the next
+   call without it, which may pass no handles at all.  */
+extern int dlclose_multiple (void *const *__handles, size_t __count,
+			     int __flags) __THROWNL;
+
+/* Flag for `dlclose_multiple'.  */
+# define DLCLOSE_DEFER	1
 #endif
 
 /* When any of the above functions fails, call this function
@@ -182,6 +192,26 @@ typedef struct
   unsigned int dls_cnt;		/* Number of elements in `dls_serpath'.  */
   Dl_serpath dls_serpath[1];	/* Actually longer, dls_cnt elements.  */
 } Dl_serinfo;
+
+/* Information about the object containing a code address, as returned
+   by `_dl_find_object'.  */
+struct dl_find_object
+{
+  unsigned long long int dlfo_flags;	/* Currently always zero.  */
+  void *dlfo_map_start;		/* Beginning of the object's mapping.  */
+  void *dlfo_map_end;		/* End of the object's mapping.  */
+  struct link_map *dlfo_link_map; /* The object's link map.  */
+  void *dlfo_eh_frame;		/* PT_GNU_EH_FRAME data, or null.  */
+  unsigned long long int __dlfo_reserved[7];
+};
+
+/* Fill in *RESULT with information about the object which contains the
+   address PC.  Returns 0 on success and -1 if PC is not in any loaded
+   object.  Unlike `dl_iterate_phdr', this function does not take any
+   locks and is async-signal-safe, so it is suitable for use by
+   exception unwinders.  */
+extern int _dl_find_object (void *__pc, struct dl_find_object *__result)
+     __THROW __nonnull ((2));
 #endif /* __USE_GNU */
 
 
@@ -59,6 +59,11 @@ __dlsym (void *handle, const char *name DL_CALLER_DECL)
     return _dlfcn_hook->dlsym (handle, name, DL_CALLER);
 # endif
 
+  /* Symbols found before in the same handle do not need the lock.  */
+  void *cached = _dl_sym_cached (handle, name);
+  if (cached != NULL)
+    return cached;
+
   struct dlsym_args args;
   args.who = DL_CALLER;
   args.handle = handle;
@@ -0,0 +1 @@
+#include "dlclose_multiple.c"
@@ -0,0 +1,123 @@
+/* Test dlclose_multiple.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <link.h>
+#include <stdbool.h>
+#include <string.h>
+#include <support/check.h>
+
+static const char *const names[] =
+  {
+    "moddummy1.so", "moddummy2.so", "glreflib1.so"
+  };
+#define NNAMES (sizeof (names) / sizeof (names[0]))
+
+static int
+find_object (struct dl_phdr_info *info, size_t size, void *closure)
+{
+  const char *name = closure;
+  const char *slash = strrchr (info->dlpi_name, '/');
+  const char *base = slash != NULL ? slash + 1 : info->dlpi_name;
+  return strcmp (base, name) == 0;
+}
+
+/* Return true if NAME is still loaded.  This does not use
+   RTLD_NOLOAD because that would open the object again.  */
+static bool
+is_loaded (const char *name)
+{
+  return dl_iterate_phdr (find_object, (void *) name) != 0;
+}
+
+static void
+open_all (void **handles)
+{
+  for (size_t i = 0; i < NNAMES; ++i)
+    {
+      handles[i] = dlopen (names[i], RTLD_NOW);
+      if (handles[i] == NULL)
+	FAIL_EXIT1 ("dlopen (%s): %s", names[i], dlerror ());
+      TEST_VERIFY (is_loaded (names[i]));
+    }
+}
+
+static int
+do_test (void)
+{
+  void *handles[NNAMES + 1];
+
+  /* Everything is unloaded by a single call.  */
+  open_all (handles);
+  TEST_VERIFY (dlclose_multiple (handles, NNAMES, 0) == 0);
+  for (size_t i = 0; i < NNAMES; ++i)
+    TEST_VERIFY (!is_loaded (names[i]));
+
+  /* An object opened twice stays loaded until both handles are
+     closed.  */
+  open_all (handles);
+  handles[NNAMES] = dlopen (names[0], RTLD_NOW);
+  TEST_VERIFY_EXIT (handles[NNAMES] == handles[0]);
+  TEST_VERIFY (dlclose_multiple (&handles[1], NNAMES, 0) == 0);
+  TEST_VERIFY (is_loaded (names[0]));
+  for (size_t i = 1; i < NNAMES; ++i)
+    TEST_VERIFY (!is_loaded (names[i]));
+  TEST_VERIFY (dlclose (handles[0]) == 0);
+  TEST_VERIFY (!is_loaded (names[0]));
+
+  /* Closing a handle more often than it was opened fails without
+     closing anything.  */
+  open_all (handles);
+  handles[NNAMES] = handles[0];
+  TEST_VERIFY (dlclose_multiple (handles, NNAMES + 1, 0) == -1);
+  TEST_VERIFY (dlerror () != NULL);
+  for (size_t i = 0; i < NNAMES; ++i)
+    TEST_VERIFY (is_loaded (names[i]));
+
+  /* Unknown flags are rejected.  */
+  TEST_VERIFY (dlclose_multiple (handles, NNAMES, ~DLCLOSE_DEFER) == -1);
+  TEST_VERIFY (dlerror () != NULL);
+  for (size_t i = 0; i < NNAMES; ++i)
+    TEST_VERIFY (is_loaded (names[i]));
+
+  /* With DLCLOSE_DEFER, the objects stay until the next call without
+     it.  */
+  TEST_VERIFY (dlclose_multiple (handles, 1, DLCLOSE_DEFER) == 0);
+  TEST_VERIFY (is_loaded (names[0]));
+  TEST_VERIFY (dlclose_multiple (&handles[1], NNAMES - 1, DLCLOSE_DEFER)
+	       == 0);
+  for (size_t i = 0; i < NNAMES; ++i)
+    TEST_VERIFY (is_loaded (names[i]));
+
+  /* An object whose unloading has been deferred can be opened again,
+     which keeps it loaded.  */
+  void *again = dlopen (names[1], RTLD_NOW);
+  TEST_VERIFY_EXIT (again == handles[1]);
+
+  TEST_VERIFY (dlclose_multiple (NULL, 0, 0) == 0);
+  TEST_VERIFY (!is_loaded (names[0]));
+  TEST_VERIFY (is_loaded (names[1]));
+  TEST_VERIFY (!is_loaded (names[2]));
+
+  TEST_VERIFY (dlclose (again) == 0);
+  TEST_VERIFY (!is_loaded (names[1]));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -48,6 +48,9 @@ struct cache_entry
 /* List of all cache entries.  */
 static struct cache_entry *entries;
 
+/* Where add_to_cache appends the next entry.  */
+static struct cache_entry **entries_end = &entries;
+
 static const char *flag_descr[] =
 { "libc4", "ELF", "libc5", "libc6"};
 
@@ -250,6 +253,7 @@ void
 init_cache (void)
 {
   entries = NULL;
+  entries_end = &entries;
 }
 
 static int
@@ -280,11 +284,112 @@ compare (const struct cache_entry *e1, const struct cache_entry *e2)
   return res;
 }
 
+/* Merge the sorted lists A and B.  Equal entries from A come first.  */
+static struct cache_entry *
+merge_entries (struct cache_entry *a, struct cache_entry *b)
+{
+  struct cache_entry *head;
+  struct cache_entry **tail = &head;
+
+  while (a != NULL && b != NULL)
+    if (compare (a, b) <= 0)
+      {
+	*tail = a;
+	tail = &a->next;
+	a = a->next;
+      }
+    else
+      {
+	*tail = b;
+	tail = &b->next;
+	b = b->next;
+      }
+  *tail = a != NULL ? a : b;
+
+  return head;
+}
+
+/* Sort LIST with a merge sort.  The sort is stable, so of several
+   entries which compare equal the one added first stays first.  */
+static struct cache_entry *
+sort_entries (struct cache_entry *list)
+{
+  if (list == NULL || list->next == NULL)
+    return list;
+
+  /* Split the list in the middle.  */
+  struct cache_entry *slow = list;
+  for (struct cache_entry *fast = list->next;
+       fast != NULL && fast->next != NULL; fast = fast->next->next)
+    slow = slow->next;
+  struct cache_entry *second = slow->next;
+  slow->next = NULL;
+
+  return merge_entries (sort_entries (list), sort_entries (second));
+}
+
+/* Build the hash table for the new format from the sorted list of
+   entries and store its size in *SIZE.  */
+static struct cache_hash_table *
+build_hash_table (size_t *size)
+{
+  /* Entries with the same name are adjacent in the list.  Count the
+     names first.  */
+  uint32_t nnames = 0;
+  for (struct cache_entry *entry = entries; entry != NULL; )
+    {
+      struct cache_entry *next = entry->next;
+      while (next != NULL && _dl_cache_libcmp (entry->lib, next->lib) == 0)
+	next = next->next;
+      ++nnames;
+      entry = next;
+    }
+
+  /* Keep the load factor below 50%, which also guarantees an empty
+     slot.  */
+  uint32_t nslots = 1;
+  while (nslots <= 2 * nnames)
+    nslots *= 2;
+
+  *size = (sizeof (struct cache_hash_table)
+	   + nslots * sizeof (struct cache_hash_slot));
+  struct cache_hash_table *table = xmalloc (*size);
+  memset (table, '\0', *size);
+  table->magic = CACHE_HASH_MAGIC;
+  table->nslots = nslots;
+
+  uint32_t idx = 0;
+  for (struct cache_entry *entry = entries; entry != NULL; )
+    {
+      uint32_t count = 1;
+      struct cache_entry *next = entry->next;
+      while (next != NULL && _dl_cache_libcmp (entry->lib, next->lib) == 0)
+	{
+	  ++count;
+	  next = next->next;
+	}
+
+      uint32_t hash = _dl_cache_hash (entry->lib);
+      uint32_t i = hash & (nslots - 1);
+      while (table->slots[i].first != 0)
+	i = (i + 1) & (nslots - 1);
+      table->slots[i].hash = hash;
+      table->slots[i].first = idx + 1;
+      table->slots[i].count = count;
+
+      idx += count;
+      entry = next;
+    }
+
+  return table;
+}
+
 /* Save the contents of the cache.  */
 void
 save_cache (const char *cache_name)
 {
-  /* The cache entries are sorted already, save them in this order. */
+  /* Sort the cache entries, and save them in this order.  */
+  entries = sort_entries (entries);
 
   /* Count the length of all strings.  */
   /* The old format doesn't contain hwcap entries and doesn't contain
@@ -333,6 +438,9 @@ save_cache (const char *cache_name)
 
   struct cache_file_new *file_entries_new = NULL;
   size_t file_entries_new_size = 0;
+  struct cache_hash_table *hash_table = NULL;
+  size_t hash_table_size = 0;
+  size_t hash_pad = 0;
 
   if (opt_format != 0)
     {
@@ -350,6 +458,12 @@ save_cache (const char *cache_name)
 
       file_entries_new->nlibs = cache_entry_count;
       file_entries_new->len_strings = total_strlen;
+
+      /* The hash table follows the string table.  */
+      hash_table = build_hash_table (&hash_table_size);
+      hash_pad = (-total_strlen) % __alignof__ (struct cache_hash_table);
+      file_entries_new->hash_offset = (file_entries_new_size + total_strlen
+				       + hash_pad);
     }
 
   /* Pad for alignment of cache_file_new.  */
@@ -448,8 +562,20 @@ save_cache (const char *cache_name)
 	error (EXIT_FAILURE, errno, _("Writing of cache data failed"));
     }
 
-  if (write (fd, strings, total_strlen) != (ssize_t) total_strlen
-      || close (fd))
+  if (write (fd, strings, total_strlen) != (ssize_t) total_strlen)
+    error (EXIT_FAILURE, errno, _("Writing of cache data failed"));
+
+  if (opt_format != 0)
+    {
+      char zero[hash_pad + 1];
+      memset (zero, '\0', hash_pad);
+      if (write (fd, zero, hash_pad) != (ssize_t) hash_pad
+	  || (write (fd, hash_table, hash_table_size)
+	      != (ssize_t) hash_table_size))
+	error (EXIT_FAILURE, errno, _("Writing of cache data failed"));
+    }
+
+  if (close (fd))
     error (EXIT_FAILURE, errno, _("Writing of cache data failed"));
 
   /* Make sure user can always read cache file */
@@ -464,6 +590,7 @@ save_cache (const char *cache_name)
 	   cache_name);
 
   /* Free all allocated memory.  */
+  free (hash_table);
   free (file_entries_new);
   free (file_entries);
   free (strings);
@@ -474,6 +601,7 @@ save_cache (const char *cache_name)
       entries = entries->next;
       free (entry);
     }
+  entries_end = &entries;
 }
 
 
@@ -501,28 +629,10 @@ add_to_cache (const char *path, const char *lib, int flags,
     if ((hwcap & (1ULL << i)) != 0)
       ++new_entry->bits_hwcap;
 
-
-  /* Keep the list sorted - search for right place to insert.  */
-  struct cache_entry *ptr = entries;
-  struct cache_entry *prev = entries;
-  while (ptr != NULL)
-    {
-      if (compare (ptr, new_entry) > 0)
-	break;
-      prev = ptr;
-      ptr = ptr->next;
-    }
-  /* Is this the first entry?  */
-  if (ptr == entries)
-    {
-      new_entry->next = entries;
-      entries = new_entry;
-    }
-  else
-    {
-      new_entry->next = prev->next;
-      prev->next = new_entry;
-    }
+  /* The list is sorted by save_cache.  */
+  new_entry->next = NULL;
+  *entries_end = new_entry;
+  entries_end = &new_entry->next;
 }
 
 
@@ -531,7 +641,8 @@ add_to_cache (const char *path, const char *lib, int flags,
 struct aux_cache_entry_id
 {
   uint64_t ino;
-  uint64_t ctime;
+  uint64_t ctime;		/* In nanoseconds.  */
+  uint64_t mtime;		/* In nanoseconds.  */
   uint64_t size;
   uint64_t dev;
 };
@@ -546,7 +657,7 @@ struct aux_cache_entry
   struct aux_cache_entry *next;
 };
 
-#define AUX_CACHEMAGIC		"glibc-ld.so.auxcache-1.0"
+#define AUX_CACHEMAGIC		"glibc-ld.so.auxcache-1.1"
 
 struct aux_cache_file_entry
 {
@@ -584,10 +695,27 @@ static struct aux_cache_entry **aux_hash;
 static unsigned int
 aux_cache_entry_id_hash (struct aux_cache_entry_id *id)
 {
-  uint64_t ret = ((id->ino * 11 + id->ctime) * 11 + id->size) * 11 + id->dev;
+  uint64_t ret = (((id->ino * 11 + id->ctime) * 11 + id->mtime) * 11
+		  + id->size) * 11 + id->dev;
   return ret ^ (ret >> 32);
 }
 
+/* Fill in the ID of the file described by STAT_BUF.  The times are
+   stored with full precision because a library can be replaced several
+   times within one second.  */
+static void
+aux_cache_entry_id_init (struct aux_cache_entry_id *id,
+			 const struct stat64 *stat_buf)
+{
+  id->ino = (uint64_t) stat_buf->st_ino;
+  id->ctime = ((uint64_t) stat_buf->st_ctim.tv_sec * 1000000000
+	       + stat_buf->st_ctim.tv_nsec);
+  id->mtime = ((uint64_t) stat_buf->st_mtim.tv_sec * 1000000000
+	       + stat_buf->st_mtim.tv_nsec);
+  id->size = (uint64_t) stat_buf->st_size;
+  id->dev = (uint64_t) stat_buf->st_dev;
+}
+
 static size_t nextprime (size_t x)
 {
   for (unsigned int i = 0; i < sizeof (primes) / sizeof (primes[0]); ++i)
@@ -608,16 +736,14 @@ search_aux_cache (struct stat64 *stat_buf, int *flags,
 		  unsigned int *osversion, char **soname)
 {
   struct aux_cache_entry_id id;
-  id.ino = (uint64_t) stat_buf->st_ino;
-  id.ctime = (uint64_t) stat_buf->st_ctime;
-  id.size = (uint64_t) stat_buf->st_size;
-  id.dev = (uint64_t) stat_buf->st_dev;
+  aux_cache_entry_id_init (&id, stat_buf);
 
   unsigned int hash = aux_cache_entry_id_hash (&id);
   struct aux_cache_entry *entry;
   for (entry = aux_hash[hash % aux_hash_size]; entry; entry = entry->next)
     if (id.ino == entry->id.ino
 	&& id.ctime == entry->id.ctime
+	&& id.mtime == entry->id.mtime
 	&& id.size == entry->id.size
 	&& id.dev == entry->id.dev)
       {
@@ -643,6 +769,7 @@ insert_to_aux_cache (struct aux_cache_entry_id *id, int flags,
   for (entry = aux_hash[hash]; entry; entry = entry->next)
     if (id->ino == entry->id.ino
 	&& id->ctime == entry->id.ctime
+	&& id->mtime == entry->id.mtime
 	&& id->size == entry->id.size
 	&& id->dev == entry->id.dev)
       abort ();
@@ -666,10 +793,7 @@ add_to_aux_cache (struct stat64 *stat_buf, int flags,
 		  unsigned int osversion, const char *soname)
 {
   struct aux_cache_entry_id id;
-  id.ino = (uint64_t) stat_buf->st_ino;
-  id.ctime = (uint64_t) stat_buf->st_ctime;
-  id.size = (uint64_t) stat_buf->st_size;
-  id.dev = (uint64_t) stat_buf->st_dev;
+  aux_cache_entry_id_init (&id, stat_buf);
   insert_to_aux_cache (&id, flags, osversion, soname, 1);
 }
 
@@ -18,30 +18,59 @@
 
 #include <dlfcn.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <ldsodefs.h>
+#include <libc-pointer-arith.h>
 
 
-static inline void
+/* Return true if SYM is a candidate for dladdr.  GNU_HASH says
+   whether SYM was found through the GNU hash table, which never
+   references local symbols.  */
+static inline bool
 __attribute ((always_inline))
-determine_info (const ElfW(Addr) addr, struct link_map *match, Dl_info *info,
-		struct link_map **mapp, const ElfW(Sym) **symbolp)
+dladdr_candidate_p (const ElfW(Sym) *sym, bool gnu_hash,
+		    ElfW(Word) strtabsize)
 {
-  /* Now we know what object the address lies in.  */
-  info->dli_fname = match->l_name;
-  info->dli_fbase = (void *) match->l_map_start;
-
-  /* If this is the main program the information is incomplete.  */
-  if (__builtin_expect (match->l_name[0], 'a') == '\0'
-      && match->l_type == lt_executable)
-    info->dli_fname = _dl_argv[0];
+  if (!gnu_hash
+      && ((ELFW(ST_BIND) (sym->st_info) != STB_GLOBAL
+	   && ELFW(ST_BIND) (sym->st_info) != STB_WEAK)
+	  || __glibc_unlikely (dl_symbol_visibility_binds_local_p (sym))))
+    return false;
+  return ((sym->st_shndx != SHN_UNDEF || sym->st_value != 0)
+	  && ELFW(ST_TYPE) (sym->st_info) != STT_TLS
+	  && sym->st_name < strtabsize);
+}
 
+/* Walk the dynamic symbol table of MATCH in symbol table order.  If
+   MATCHSYM is not NULL, store in *MATCHSYM the symbol nearest to ADDR,
+   determined by DL_ADDR_SYM_MATCH.  Otherwise return the number of
+   candidate symbols and, if INDEX is not NULL, store their indices
+   there.  */
+static inline size_t
+__attribute ((always_inline))
+scan_symbols (struct link_map *match, ElfW(Addr) addr,
+	      const ElfW(Sym) **matchsym, Elf32_Word *index)
+{
   const ElfW(Sym) *symtab
     = (const ElfW(Sym) *) D_PTR (match, l_info[DT_SYMTAB]);
   const char *strtab = (const char *) D_PTR (match, l_info[DT_STRTAB]);
 
   ElfW(Word) strtabsize = match->l_info[DT_STRSZ]->d_un.d_val;
+  size_t count = 0;
+
+#define VISIT(symndx, gnu_hash)						      \
+  if (dladdr_candidate_p (&symtab[symndx], gnu_hash, strtabsize))	      \
+    {									      \
+      if (matchsym == NULL)						      \
+	{								      \
+	  if (index != NULL)						      \
+	    index[count] = symndx;					      \
+	  ++count;							      \
+	}								      \
+      else if (DL_ADDR_SYM_MATCH (match, &symtab[symndx], *matchsym, addr))  \
+	*matchsym = &symtab[symndx];					      \
+    }
 
-  const ElfW(Sym) *matchsym = NULL;
   if (match->l_info[DT_ADDRTAGIDX (DT_GNU_HASH) + DT_NUM + DT_THISPROCNUM
 		    + DT_VERSIONTAGNUM + DT_EXTRANUM + DT_VALNUM] != NULL)
     {
@@ -56,16 +85,7 @@ determine_info (const ElfW(Addr) addr, struct link_map *match, Dl_info *info,
 
 	      do
 		{
-		  /* The hash table never references local symbols so
-		     we can omit that test here.  */
-		  if ((symtab[symndx].st_shndx != SHN_UNDEF
-		       || symtab[symndx].st_value != 0)
-		      && ELFW(ST_TYPE) (symtab[symndx].st_info) != STT_TLS
-		      && DL_ADDR_SYM_MATCH (match, &symtab[symndx],
-					    matchsym, addr)
-		      && symtab[symndx].st_name < strtabsize)
-		    matchsym = (ElfW(Sym) *) &symtab[symndx];
-
+		  VISIT (symndx, true);
 		  ++symndx;
 		}
 	      while ((*hasharr++ & 1u) == 0);
@@ -74,28 +94,161 @@ determine_info (const ElfW(Addr) addr, struct link_map *match, Dl_info *info,
     }
   else
     {
-      const ElfW(Sym) *symtabend;
+      Elf32_Word symtabsize;
       if (match->l_info[DT_HASH] != NULL)
-	symtabend = (symtab
-		     + ((Elf_Symndx *) D_PTR (match, l_info[DT_HASH]))[1]);
+	symtabsize = ((Elf_Symndx *) D_PTR (match, l_info[DT_HASH]))[1];
       else
 	/* There is no direct way to determine the number of symbols in the
 	   dynamic symbol table and no hash table is present.  The ELF
 	   binary is ill-formed but what shall we do?  Use the beginning of
 	   the string table which generally follows the symbol table.  */
-	symtabend = (const ElfW(Sym) *) strtab;
-
-      for (; (void *) symtab < (void *) symtabend; ++symtab)
-	if ((ELFW(ST_BIND) (symtab->st_info) == STB_GLOBAL
-	     || ELFW(ST_BIND) (symtab->st_info) == STB_WEAK)
-	    && __glibc_likely (!dl_symbol_visibility_binds_local_p (symtab))
-	    && ELFW(ST_TYPE) (symtab->st_info) != STT_TLS
-	    && (symtab->st_shndx != SHN_UNDEF
-		|| symtab->st_value != 0)
-	    && DL_ADDR_SYM_MATCH (match, symtab, matchsym, addr)
-	    && symtab->st_name < strtabsize)
-	  matchsym = (ElfW(Sym) *) symtab;
+	symtabsize = ((const ElfW(Sym) *) strtab > symtab
+		      ? (const ElfW(Sym) *) strtab - symtab : 0);
+
+      for (Elf32_Word symndx = 0; symndx < symtabsize; ++symndx)
+	VISIT (symndx, false);
+    }
+#undef VISIT
+
+  return count;
+}
+
+#if DL_ADDR_SYM_INDEX
+/* Order symbol indices by symbol value.  Symbols with the same value
+   keep their symbol table order, which is the order in which the
+   linear scan considers them.  */
+static int
+compare_symbols (const void *a, const void *b, void *closure)
+{
+  const ElfW(Sym) *symtab = closure;
+  Elf32_Word ia = *(const Elf32_Word *) a;
+  Elf32_Word ib = *(const Elf32_Word *) b;
+  if (symtab[ia].st_value != symtab[ib].st_value)
+    return symtab[ia].st_value < symtab[ib].st_value ? -1 : 1;
+  return ia < ib ? -1 : ia > ib;
+}
+
+/* Build MATCH->l_addr_index and MATCH->l_addr_index_reach.  The index
+   uses four bytes per candidate symbol plus one address for its reach,
+   which is a small fraction of the size of the symbol table itself.
+   Returns false if the memory could not be allocated, in which case the
+   caller falls back to the linear scan.  */
+static bool
+build_index (struct link_map *match)
+{
+  const ElfW(Sym) *symtab
+    = (const ElfW(Sym) *) D_PTR (match, l_info[DT_SYMTAB]);
+
+  /* First count the candidates, then fill in the index.  The extra
+     element keeps the pointer non-null for objects without any
+     candidate symbol, so that the index is not rebuilt.  The reach
+     array follows the index in the same allocation.  */
+  size_t count = scan_symbols (match, 0, NULL, NULL);
+  size_t reach_offset = ALIGN_UP ((count + 1) * sizeof (Elf32_Word),
+				  __alignof__ (ElfW(Addr)));
+  Elf32_Word *index = malloc (reach_offset + count * sizeof (ElfW(Addr)));
+  if (index == NULL)
+    return false;
+  scan_symbols (match, 0, NULL, index);
+  __qsort_r (index, count, sizeof (*index), compare_symbols, (void *) symtab);
+
+  /* REACH[I] is the largest end address of the symbols up to and
+     including INDEX[I].  No symbol at or before I can contain an
+     address at or beyond it.  */
+  ElfW(Addr) *reach = (ElfW(Addr) *) ((char *) index + reach_offset);
+  ElfW(Addr) maxend = 0;
+  for (size_t i = 0; i < count; ++i)
+    {
+      const ElfW(Sym) *sym = &symtab[index[i]];
+      ElfW(Addr) end = sym->st_value + sym->st_size;
+      if (end < sym->st_value)
+	end = (ElfW(Addr)) -1;
+      if (end > maxend)
+	maxend = end;
+      reach[i] = maxend;
+    }
+
+  match->l_addr_index = index;
+  match->l_addr_index_size = count;
+  match->l_addr_index_reach = reach;
+  return true;
+}
+
+/* Return the symbol nearest to ADDR using MATCH->l_addr_index.  The
+   result is the same as that of the linear scan in scan_symbols: the
+   matching symbol with the largest value and, among those, the first
+   one in symbol table order.  */
+static const ElfW(Sym) *
+lookup_index (struct link_map *match, const ElfW(Sym) *symtab,
+	      ElfW(Addr) addr)
+{
+  const Elf32_Word *index = match->l_addr_index;
+  if (addr < match->l_addr)
+    return NULL;
+  ElfW(Addr) value = addr - match->l_addr;
+
+  /* Find the first symbol with st_value greater than VALUE.  */
+  size_t lo = 0;
+  size_t hi = match->l_addr_index_size;
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      if (symtab[index[mid]].st_value <= value)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* Walk back until no symbol can reach VALUE any more.  */
+  const ElfW(Sym) *const none = NULL;
+  const ElfW(Sym) *matchsym = NULL;
+  while (lo > 0)
+    {
+      const ElfW(Sym) *sym = &symtab[index[--lo]];
+      if (matchsym != NULL)
+	{
+	  /* Only earlier symbols with the same value take precedence.  */
+	  if (sym->st_value != matchsym->st_value)
+	    break;
+	  if (DL_ADDR_SYM_MATCH (match, sym, none, addr))
+	    matchsym = sym;
+	}
+      else if (DL_ADDR_SYM_MATCH (match, sym, none, addr))
+	matchsym = sym;
+      else if (match->l_addr_index_reach[lo] <= value
+	       && sym->st_value != value)
+	break;
     }
+  return matchsym;
+}
+#endif
+
+static inline void
+__attribute ((always_inline))
+determine_info (const ElfW(Addr) addr, struct link_map *match, Dl_info *info,
+		struct link_map **mapp, const ElfW(Sym) **symbolp,
+		bool build)
+{
+  /* Now we know what object the address lies in.  */
+  info->dli_fname = match->l_name;
+  info->dli_fbase = (void *) match->l_map_start;
+
+  /* If this is the main program the information is incomplete.  */
+  if (__builtin_expect (match->l_name[0], 'a') == '\0'
+      && match->l_type == lt_executable)
+    info->dli_fname = _dl_argv[0];
+
+  const ElfW(Sym) *symtab
+    = (const ElfW(Sym) *) D_PTR (match, l_info[DT_SYMTAB]);
+  const char *strtab = (const char *) D_PTR (match, l_info[DT_STRTAB]);
+
+  const ElfW(Sym) *matchsym = NULL;
+#if DL_ADDR_SYM_INDEX
+  if (match->l_addr_index != NULL || (build && build_index (match)))
+    matchsym = lookup_index (match, symtab, addr);
+  else
+#endif
+    scan_symbols (match, addr, &matchsym, NULL);
 
   if (mapp)
     *mapp = match;
@@ -120,10 +273,12 @@ determine_info (const ElfW(Addr) addr, struct link_map *match, Dl_info *info,
 }
 
 
-int
-internal_function
-_dl_addr (const void *address, Dl_info *info,
-	  struct link_map **mapp, const ElfW(Sym) **symbolp)
+/* Common part of _dl_addr and _dl_addr_index.  BUILD says whether the
+   symbol index of the matching object may be built if it does not
+   exist yet.  */
+static int
+dl_addr (const void *address, Dl_info *info,
+	 struct link_map **mapp, const ElfW(Sym) **symbolp, bool build)
 {
   const ElfW(Addr) addr = DL_LOOKUP_ADDRESS (address);
   int result = 0;
@@ -135,7 +290,7 @@ _dl_addr (const void *address, Dl_info *info,
 
   if (l)
     {
-      determine_info (addr, l, info, mapp, symbolp);
+      determine_info (addr, l, info, mapp, symbolp, build);
       result = 1;
     }
 
@@ -143,4 +298,23 @@ _dl_addr (const void *address, Dl_info *info,
 
   return result;
 }
+
+/* This does not allocate memory, as it is used by the async-signal-safe
+   backtrace_symbols_fd and by malloc itself.  Objects without a symbol
+   index are scanned linearly.  */
+int
+internal_function
+_dl_addr (const void *address, Dl_info *info,
+	  struct link_map **mapp, const ElfW(Sym) **symbolp)
+{
+  return dl_addr (address, info, mapp, symbolp, false);
+}
 libc_hidden_def (_dl_addr)
+
+int
+internal_function
+_dl_addr_index (const void *address, Dl_info *info,
+		struct link_map **mapp, const ElfW(Sym) **symbolp)
+{
+  return dl_addr (address, info, mapp, symbolp, true);
+}
@@ -20,6 +20,7 @@
 #include <unistd.h>
 #include <ldsodefs.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <dl-cache.h>
 #include <dl-procinfo.h>
 #include <stdint.h>
@@ -35,6 +36,16 @@ static struct cache_file *cache;
 static struct cache_file_new *cache_new;
 static size_t cachesize;
 
+/* The hash table of the new format, or NULL.  */
+static const struct cache_hash_table *cache_hash;
+
+#ifndef MAP_COPY
+/* The identity of the mapped file, and whether it has to be compared
+   with the file on disk before the next lookup.  */
+static struct stat64 cache_stat;
+static bool cache_check_stat;
+#endif
+
 /* 1 if cache_data + PTR points into the cache.  */
 #define _dl_cache_verify_ptr(ptr) (ptr < cache_data_size)
 
@@ -173,6 +184,22 @@ _dl_cache_libcmp (const char *p1, const char *p2)
 }
 
 
+#ifndef MAP_COPY
+/* Return true if ST describes the same file as cache_stat.  */
+static bool
+cache_stat_equal (const struct stat64 *st)
+{
+  return (st->st_dev == cache_stat.st_dev
+	  && st->st_ino == cache_stat.st_ino
+	  && st->st_size == cache_stat.st_size
+	  && st->st_mtime == cache_stat.st_mtime
+# ifdef _STATBUF_ST_NSEC
+	  && st->st_mtim.tv_nsec == cache_stat.st_mtim.tv_nsec
+# endif
+	  );
+}
+#endif
+
 /* Look up NAME in ld.so.cache and return the file name stored there, or null
    if none is found.  The cache is loaded if it was not already.  If loading
    the cache previously failed there will be no more attempts to load it.
@@ -194,8 +221,32 @@ _dl_load_cache_lookup (const char *name)
   if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
     _dl_debug_printf (" search cache=%s\n", LD_SO_CACHE);
 
+#ifndef MAP_COPY
+  /* The cache has been kept mapped after the last dlopen.  Use it again
+     unless ldconfig has replaced the file in the meantime.  */
+  if (cache_check_stat)
+    {
+      struct stat64 st;
+      cache_check_stat = false;
+      if (cache != NULL && cache != (void *) -1
+	  && (__xstat64 (_STAT_VER, LD_SO_CACHE, &st) != 0
+	      || !cache_stat_equal (&st)))
+	{
+	  __munmap (cache, cachesize);
+	  cache = NULL;
+	}
+    }
+#endif
+
   if (cache == NULL)
     {
+#ifndef MAP_COPY
+      /* Record the identity of the file before reading it.  If it is
+	 replaced after the stat call, the next check reloads it.  */
+      if (__xstat64 (_STAT_VER, LD_SO_CACHE, &cache_stat) != 0)
+	cache_stat.st_ino = 0;
+#endif
+
       /* Read the contents of the file.  */
       void *file = _dl_sysdep_read_whole_file (LD_SO_CACHE, &cachesize,
 					       PROT_READ);
@@ -237,6 +288,13 @@ _dl_load_cache_lookup (const char *name)
 	}
 
       assert (cache != NULL);
+
+      if (cache_new != (void *) -1 && cache != (void *) -1)
+	cache_hash = _dl_cache_hash_table (cache_new,
+					   ((const char *) cache + cachesize
+					    - (const char *) cache_new));
+      else
+	cache_hash = NULL;
     }
 
   if (cache == (void *) -1)
@@ -275,7 +333,35 @@ _dl_load_cache_lookup (const char *name)
 	  && (lib->hwcap & _DL_HWCAP_PLATFORM) != 0			      \
 	  && (lib->hwcap & _DL_HWCAP_PLATFORM) != platform)		      \
 	continue
-      SEARCH_CACHE (cache_new);
+      if (cache_hash != NULL)
+	{
+	  /* All entries for NAME are adjacent and sorted like for the
+	     binary search, so the first usable one is the best.  */
+	  const struct cache_hash_slot *slot
+	    = _dl_cache_hash_lookup (cache_new, cache_data_size, cache_hash,
+				     name);
+	  if (slot != NULL)
+	    for (uint32_t i = slot->first - 1;
+		 i < slot->first - 1 + slot->count; ++i)
+	      {
+		const struct file_entry_new *lib = &cache_new->libs[i];
+		int flags = lib->flags;
+		if (_dl_cache_check_flags (flags)
+		    && _dl_cache_verify_ptr (lib->value)
+		    && (best == NULL || flags == GLRO(dl_correct_cache_id)))
+		  {
+		    HWCAP_CHECK;
+		    best = cache_data + lib->value;
+
+		    if (flags == GLRO(dl_correct_cache_id))
+		      /* We've found an exact match for the shared object
+			 and no general `ELF' release.  Stop searching.  */
+		      break;
+		  }
+	      }
+	}
+      else
+	SEARCH_CACHE (cache_new);
     }
   else
     {
@@ -321,5 +407,18 @@ _dl_unload_cache (void)
       __munmap (cache, cachesize);
       cache = NULL;
     }
+  cache_check_stat = false;
+}
+
+/* Used by dlopen instead of _dl_unload_cache.  Rather than reading the
+   file again for the next dlopen, keep it mapped and only check with a
+   stat call that it has not been replaced.  ldconfig always writes a
+   new file and renames it over the old one, so the mapping never sees
+   a partially written cache.  */
+void
+_dl_release_cache (void)
+{
+  if (cache != NULL && cache != (struct cache_file *) -1)
+    cache_check_stat = true;
 }
 #endif
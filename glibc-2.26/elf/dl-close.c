@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <atomic.h>
 #include <libc-lock.h>
 #include <ldsodefs.h>
 #include <sys/types.h>
@@ -32,6 +33,8 @@
 #include <sysdep-cancel.h>
 #include <tls.h>
 #include <stap-probe.h>
+#include <dl-find_object.h>
+#include <dl-sym-cache.h>
 
 #include <dl-unmap-segments.h>
 
@@ -107,36 +110,25 @@ remove_slotinfo (size_t idx, struct dtv_slotinfo_list *listp, size_t disp,
 }
 
 
-void
-_dl_close_worker (struct link_map *map, bool force)
-{
-  /* One less direct use.  */
-  --map->l_direct_opencount;
+/* If _dl_close is called recursively (some destructor call dlclose),
+   just record that the parent _dl_close will need to do garbage collection
+   again and return.  */
+static enum { not_pending, pending, rerun } dl_close_state;
 
-  /* If _dl_close is called recursively (some destructor call dlclose),
-     just record that the parent _dl_close will need to do garbage collection
-     again and return.  */
-  static enum { not_pending, pending, rerun } dl_close_state;
+/* Namespaces in which _dl_close_multiple with DLCLOSE_DEFER has dropped
+   the last reference to an object without unloading it yet.  */
+static bool gc_deferred[DL_NNS];
 
-  if (map->l_direct_opencount > 0 || map->l_type != lt_loaded
-      || dl_close_state != not_pending)
-    {
-      if (map->l_direct_opencount == 0 && map->l_type == lt_loaded)
-	dl_close_state = rerun;
 
-      /* There are still references to this object.  Do nothing more.  */
-      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
-	_dl_debug_printf ("\nclosing file=%s; direct_opencount=%u\n",
-			  map->l_name, map->l_direct_opencount);
-
-      return;
-    }
-
-  Lmid_t nsid = map->l_ns;
+/* Unload all objects in namespace NSID which are no longer used.  */
+static void
+dl_close_gc (Lmid_t nsid)
+{
   struct link_namespaces *ns = &GL(dl_ns)[nsid];
 
  retry:
   dl_close_state = pending;
+  gc_deferred[nsid] = false;
 
   bool any_tls = false;
   const unsigned int nloaded = ns->_ns_nloaded;
@@ -144,14 +136,6 @@ _dl_close_worker (struct link_map *map, bool force)
   char done[nloaded];
   struct link_map *maps[nloaded];
 
-  /* Clear DF_1_NODELETE to force object deletion.  We don't need to touch
-     l_tls_dtor_count because forced object deletion only happens when an
-     error occurs during object load.  Destructor registration for TLS
-     non-POD objects should not have happened till then for this
-     object.  */
-  if (force)
-    map->l_flags_1 &= ~DF_1_NODELETE;
-
   /* Run over the list and assign indexes to the link maps and enter
      them into the MAPS array.  */
   int idx = 0;
@@ -534,6 +518,10 @@ _dl_close_worker (struct link_map *map, bool force)
   size_t tls_free_end;
   tls_free_start = tls_free_end = NO_TLS_OFFSET;
 
+  /* Drop the objects from the _dl_find_object index before they are
+     unmapped.  This is done in one step for all of them.  */
+  _dl_find_object_dlclose ();
+
   /* We modify the list of loaded objects.  */
   __rtld_lock_lock_recursive (GL(dl_load_write_lock));
 
@@ -672,6 +660,11 @@ _dl_close_worker (struct link_map *map, bool force)
 	      __rtld_lock_unlock_recursive (tab->lock);
 	    }
 
+#ifdef SHARED
+	  if (__glibc_unlikely (_dl_profile_sampling))
+	    _dl_profile_sample_remove (imap);
+#endif
+
 	  /* We can unmap all the maps at once.  We determined the
 	     start address and length when we loaded the object and
 	     the `munmap' call does the rest.  */
@@ -709,6 +702,8 @@ _dl_close_worker (struct link_map *map, bool force)
 	    free ((char *) imap->l_origin);
 
 	  free (imap->l_reldeps);
+	  free (imap->l_addr_index);
+	  _dl_sym_cache_free (imap);
 
 	  /* Print debugging message.  */
 	  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
@@ -753,8 +748,11 @@ _dl_close_worker (struct link_map *map, bool force)
   /* If we removed any object which uses TLS bump the generation counter.  */
   if (any_tls)
     {
-      if (__glibc_unlikely (++GL(dl_tls_generation) == 0))
+      size_t newgen = GL(dl_tls_generation) + 1;
+      if (__glibc_unlikely (newgen == 0))
 	_dl_fatal_printf ("TLS generation counter wrapped!  Please report as described in "REPORT_BUGS_TO".\n");
+      /* Synchronize with the acquire load in _dl_update_slotinfo.  */
+      atomic_store_release (&GL(dl_tls_generation), newgen);
 
       if (tls_free_end == GL(dl_tls_static_used))
 	GL(dl_tls_static_used) = tls_free_start;
@@ -800,6 +798,38 @@ _dl_close_worker (struct link_map *map, bool force)
 }
 
 
+void
+_dl_close_worker (struct link_map *map, bool force)
+{
+  /* One less direct use.  */
+  --map->l_direct_opencount;
+
+  if (map->l_direct_opencount > 0 || map->l_type != lt_loaded
+      || dl_close_state != not_pending)
+    {
+      if (map->l_direct_opencount == 0 && map->l_type == lt_loaded)
+	dl_close_state = rerun;
+
+      /* There are still references to this object.  Do nothing more.  */
+      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	_dl_debug_printf ("\nclosing file=%s; direct_opencount=%u\n",
+			  map->l_name, map->l_direct_opencount);
+
+      return;
+    }
+
+  /* Clear DF_1_NODELETE to force object deletion.  We don't need to touch
+     l_tls_dtor_count because forced object deletion only happens when an
+     error occurs during object load.  Destructor registration for TLS
+     non-POD objects should not have happened till then for this
+     object.  */
+  if (force)
+    map->l_flags_1 &= ~DF_1_NODELETE;
+
+  dl_close_gc (map->l_ns);
+}
+
+
 void
 _dl_close (void *_map)
 {
@@ -841,3 +871,68 @@ _dl_close (void *_map)
 
   __rtld_lock_unlock_recursive (GL(dl_load_lock));
 }
+
+
+void
+_dl_close_multiple (void *const *handles, size_t count, int flags)
+{
+  if (__glibc_unlikely ((flags & ~DLCLOSE_DEFER) != 0))
+    _dl_signal_error (EINVAL, NULL, NULL,
+		      N_("invalid flags for dlclose_multiple"));
+
+  __rtld_lock_lock_recursive (GL(dl_load_lock));
+
+  /* Drop one direct reference for every handle.  As in _dl_close,
+     objects marked DF_1_NODELETE are left alone.  If one of the
+     handles is not open, none of them is closed.  */
+  bool collect[DL_NNS] = { false };
+  for (size_t i = 0; i < count; ++i)
+    {
+      struct link_map *map = handles[i];
+
+      if (__glibc_unlikely (map->l_flags_1 & DF_1_NODELETE))
+	continue;
+
+      if (__glibc_unlikely (map->l_direct_opencount == 0))
+	{
+	  /* Undo what we have done so far.  */
+	  while (i-- > 0)
+	    {
+	      struct link_map *done = handles[i];
+	      if ((done->l_flags_1 & DF_1_NODELETE) == 0)
+		++done->l_direct_opencount;
+	    }
+
+	  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+	  _dl_signal_error (0, map->l_name, NULL,
+			    N_("shared object not open"));
+	}
+
+      if (--map->l_direct_opencount == 0 && map->l_type == lt_loaded)
+	collect[map->l_ns] = true;
+
+      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	_dl_debug_printf ("\nclosing file=%s; direct_opencount=%u\n",
+			  map->l_name, map->l_direct_opencount);
+    }
+
+  /* One garbage collection pass per namespace covers all the objects
+     which have become unused, including those left behind by earlier
+     deferred calls.  If we are called from a destructor run by an outer
+     _dl_close, only make sure the objects are collected eventually.  */
+  bool defer = (flags & DLCLOSE_DEFER) != 0 || dl_close_state != not_pending;
+  for (Lmid_t nsid = 0; nsid < DL_NNS; ++nsid)
+    if (collect[nsid] || gc_deferred[nsid])
+      {
+	if (defer)
+	  {
+	    gc_deferred[nsid] = true;
+	    if (dl_close_state != not_pending)
+	      dl_close_state = rerun;
+	  }
+	else
+	  dl_close_gc (nsid);
+      }
+
+  __rtld_lock_unlock_recursive (GL(dl_load_lock));
+}
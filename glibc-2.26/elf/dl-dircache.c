@@ -0,0 +1,46 @@
+/* Cache of search directory contents for the library search.  Generic version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldsodefs.h>
+#include <dl-dircache.h>
+
+/* Directory contents are not cached on this system, so every candidate
+   file is opened.  */
+
+bool
+_dl_dircache_may_exist (const void *dir, size_t index, const char *dirname,
+			const char *name, size_t namelen)
+{
+  return true;
+}
+
+void
+_dl_dircache_new_generation (void)
+{
+}
+
+void
+_dl_dircache_new_search (void)
+{
+}
+
+bool
+_dl_dircache_refresh_skipped (void)
+{
+  return false;
+}
@@ -0,0 +1,52 @@
+/* Cache of search directory contents for the library search.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_DIRCACHE_H
+#define _DL_DIRCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Return false if NAME (NAMELEN bytes including the terminating null
+   byte) is known not to exist in the directory DIRNAME.  Otherwise,
+   including if the contents of DIRNAME are not known, return true and
+   the caller has to try to open the file.  DIR and INDEX identify the
+   search path element and hwcap subdirectory DIRNAME has been built
+   from; the cached contents are associated with them.  All functions
+   must be called with GL(dl_load_lock) held.  */
+extern bool _dl_dircache_may_exist (const void *dir, size_t index,
+				    const char *dirname, const char *name,
+				    size_t namelen) attribute_hidden;
+
+/* Called at the start of each dlopen.  The cached contents of a
+   directory are checked against its modification time once in each
+   dlopen call before they are used again.  */
+extern void _dl_dircache_new_generation (void) attribute_hidden;
+
+/* Called at the start of each search for a file name.  */
+extern void _dl_dircache_new_search (void) attribute_hidden;
+
+/* Discard the cached contents of the directories for which
+   _dl_dircache_may_exist has returned false in the current search and
+   which have been modified in the clock tick in which they were read.
+   Return true if there are any, in which case the caller should repeat
+   a failed search, to cover files created later in that tick.  Only
+   these directories are read again.  */
+extern bool _dl_dircache_refresh_skipped (void) attribute_hidden;
+
+#endif /* _DL_DIRCACHE_H */
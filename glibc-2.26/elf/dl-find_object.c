@@ -0,0 +1,365 @@
+/* Locating objects in the process image.  Lock-free address index.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <assert.h>
+#include <atomic.h>
+#include <dlfcn.h>
+#include <dl-find_object.h>
+#include <ldsodefs.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The index is a table of address ranges sorted by start address.
+   There are two copies of the table.  Readers use the copy selected
+   by the low bit of _dlfo_version; the writer (which is serialized by
+   GL(dl_load_lock)) fills the other copy and then publishes it by
+   incrementing the version.  Readers re-check the version after the
+   lookup and retry if it changed, so they never observe a partially
+   updated table and never have to take a lock.
+
+   Tables are never freed because a reader may still be scanning a
+   table which has been replaced.  Their capacity grows geometrically,
+   so the amount of memory lost this way is bounded by a small multiple
+   of the largest index ever built.  */
+
+struct dlfo_entry
+{
+  uintptr_t map_start;
+  uintptr_t map_end;
+  struct link_map *map;
+  void *eh_frame;
+};
+
+struct dlfo_table
+{
+  /* Number of entries in the entries array.  Never changes after the
+     table has been published.  */
+  size_t allocated;
+  /* Number of entries in use.  */
+  size_t size;
+  struct dlfo_entry entries[];
+};
+
+static struct dlfo_table *_dlfo_tables[2];
+static unsigned int _dlfo_version;
+
+/* A table which has not been published yet and is large enough to
+   hold the current contents of the active table.  dlclose uses it if
+   the inactive table is too small, so that removing objects never has
+   to allocate memory.  */
+static struct dlfo_table *_dlfo_spare;
+
+/* Minimum number of entries in a freshly allocated table.  */
+enum { dlfo_min_allocation = 16 };
+
+static struct dlfo_table *
+dlfo_allocate (size_t count)
+{
+  struct dlfo_table *result = malloc (sizeof (*result)
+				      + count * sizeof (result->entries[0]));
+  if (result != NULL)
+    {
+      result->allocated = count;
+      result->size = 0;
+    }
+  return result;
+}
+
+/* Compute the index entry for the object L.  Objects which have not
+   been loaded by _dl_map_object (the main program of a static
+   executable) do not have l_map_start and l_map_end, so the range is
+   derived from the program headers.  */
+static void
+dlfo_fill (struct link_map *l, struct dlfo_entry *e)
+{
+  bool compute_range = l->l_map_end == 0;
+
+  e->map_start = compute_range ? UINTPTR_MAX : l->l_map_start;
+  e->map_end = compute_range ? 0 : l->l_map_end;
+  e->map = l;
+  e->eh_frame = NULL;
+
+  for (const ElfW(Phdr) *ph = l->l_phdr; ph < &l->l_phdr[l->l_phnum]; ++ph)
+    if (ph->p_type == PT_GNU_EH_FRAME)
+      e->eh_frame = (void *) (l->l_addr + ph->p_vaddr);
+    else if (compute_range && ph->p_type == PT_LOAD)
+      {
+	uintptr_t start = (l->l_addr
+			   + (ph->p_vaddr & ~(GLRO(dl_pagesize) - 1)));
+	uintptr_t end = l->l_addr + ph->p_vaddr + ph->p_memsz;
+	if (start < e->map_start)
+	  e->map_start = start;
+	if (end > e->map_end)
+	  e->map_end = end;
+      }
+
+  if (e->map_start >= e->map_end)
+    e->map_start = e->map_end = 0;
+}
+
+/* Write *SRC to *DST.  DST may be read concurrently.  */
+static inline void
+dlfo_store (struct dlfo_entry *dst, const struct dlfo_entry *src)
+{
+  atomic_store_relaxed (&dst->map_start, src->map_start);
+  atomic_store_relaxed (&dst->map_end, src->map_end);
+  atomic_store_relaxed (&dst->map, src->map);
+  atomic_store_relaxed (&dst->eh_frame, src->eh_frame);
+}
+
+/* Make sure the inactive table can hold COUNT entries and that the
+   active table can be replaced by one of that size after publication.
+   Returns false on allocation failure, with no visible change.  */
+static bool
+dlfo_reserve (size_t count)
+{
+  unsigned int version = atomic_load_relaxed (&_dlfo_version);
+  struct dlfo_table *active = _dlfo_tables[version & 1];
+  struct dlfo_table *inactive = _dlfo_tables[(version + 1) & 1];
+
+  size_t capacity = count * 2;
+  if (capacity < dlfo_min_allocation)
+    capacity = dlfo_min_allocation;
+
+  struct dlfo_table *new_inactive = NULL;
+  if (inactive == NULL || inactive->allocated < count)
+    {
+      new_inactive = dlfo_allocate (capacity);
+      if (new_inactive == NULL)
+	return false;
+    }
+
+  /* After publication the currently active table becomes the
+     inactive one.  */
+  struct dlfo_table *new_spare = NULL;
+  if ((active == NULL || active->allocated < count)
+      && (_dlfo_spare == NULL || _dlfo_spare->allocated < count))
+    {
+      new_spare = dlfo_allocate (capacity);
+      if (new_spare == NULL)
+	{
+	  /* Never published, so it can be freed.  */
+	  free (new_inactive);
+	  return false;
+	}
+    }
+
+  if (new_inactive != NULL)
+    /* Pairs with the acquire load in _dl_find_object, so that readers
+       which see the new pointer also see its allocated field.  */
+    atomic_store_release (&_dlfo_tables[(version + 1) & 1], new_inactive);
+  if (new_spare != NULL)
+    /* The previous spare has never been published, but it may have
+       been allocated by the minimal malloc in ld.so, so it is not
+       passed to free.  */
+    _dlfo_spare = new_spare;
+  return true;
+}
+
+/* Make the inactive table, which now holds SIZE entries, visible to
+   readers.  */
+static void
+dlfo_publish (size_t size)
+{
+  unsigned int version = atomic_load_relaxed (&_dlfo_version);
+  atomic_store_relaxed (&_dlfo_tables[(version + 1) & 1]->size, size);
+  atomic_store_release (&_dlfo_version, version + 1);
+}
+
+/* Insert the objects in namespaces [NS_START, NS_END) which have not
+   been processed yet.  */
+static bool
+dlfo_add (Lmid_t ns_start, Lmid_t ns_end)
+{
+  size_t count = 0;
+  for (Lmid_t ns = ns_start; ns < ns_end; ++ns)
+    for (struct link_map *l = GL(dl_ns)[ns]._ns_loaded; l != NULL;
+	 l = l->l_next)
+      if (!l->l_find_object_processed)
+	++count;
+  if (count == 0)
+    return true;
+
+  /* Collect and sort the new entries in a private array first.  The
+     number of objects loaded by a single dlopen call is small, so
+     insertion sort is sufficient.  */
+  struct dlfo_entry *added = malloc (count * sizeof (*added));
+  if (added == NULL)
+    return false;
+  size_t nadded = 0;
+  for (Lmid_t ns = ns_start; ns < ns_end; ++ns)
+    for (struct link_map *l = GL(dl_ns)[ns]._ns_loaded; l != NULL;
+	 l = l->l_next)
+      if (!l->l_find_object_processed)
+	{
+	  struct dlfo_entry e;
+	  dlfo_fill (l, &e);
+	  if (e.map_start == e.map_end)
+	    continue;
+	  size_t i = nadded++;
+	  while (i > 0 && added[i - 1].map_start > e.map_start)
+	    {
+	      added[i] = added[i - 1];
+	      --i;
+	    }
+	  added[i] = e;
+	}
+
+  unsigned int version = atomic_load_relaxed (&_dlfo_version);
+  struct dlfo_table *active = _dlfo_tables[version & 1];
+  size_t old_size = active != NULL ? active->size : 0;
+  if (!dlfo_reserve (old_size + nadded))
+    {
+      free (added);
+      return false;
+    }
+  struct dlfo_table *target = _dlfo_tables[(version + 1) & 1];
+
+  /* Pairs with the acquire fence in _dl_find_object: a reader which
+     observes any of the stores below will also observe the version
+     increment of the previous publication, and retry.  */
+  atomic_thread_fence_release ();
+
+  /* Merge the active table with the new entries.  */
+  size_t i = 0, j = 0, k = 0;
+  while (i < old_size || j < nadded)
+    if (j == nadded
+	|| (i < old_size && active->entries[i].map_start < added[j].map_start))
+      dlfo_store (&target->entries[k++], &active->entries[i++]);
+    else
+      dlfo_store (&target->entries[k++], &added[j++]);
+  dlfo_publish (k);
+  free (added);
+
+  for (Lmid_t ns = ns_start; ns < ns_end; ++ns)
+    for (struct link_map *l = GL(dl_ns)[ns]._ns_loaded; l != NULL;
+	 l = l->l_next)
+      l->l_find_object_processed = 1;
+  return true;
+}
+
+void
+_dl_find_object_init (void)
+{
+  if (!dlfo_add (0, GL(dl_nns)))
+    _dl_fatal_printf ("cannot allocate memory for find-object data\n");
+}
+
+bool
+_dl_find_object_update (struct link_map *new)
+{
+  return dlfo_add (new->l_ns, new->l_ns + 1);
+}
+
+void
+_dl_find_object_dlclose (void)
+{
+  unsigned int version = atomic_load_relaxed (&_dlfo_version);
+  struct dlfo_table *active = _dlfo_tables[version & 1];
+  if (active == NULL)
+    return;
+
+  size_t remaining = 0;
+  for (size_t i = 0; i < active->size; ++i)
+    if (!active->entries[i].map->l_removed)
+      ++remaining;
+  if (remaining == active->size)
+    return;
+
+  struct dlfo_table *target = _dlfo_tables[(version + 1) & 1];
+  if (target == NULL || target->allocated < remaining)
+    {
+      /* dlfo_reserve guarantees the spare is large enough.  */
+      assert (_dlfo_spare != NULL && _dlfo_spare->allocated >= remaining);
+      target = _dlfo_spare;
+      _dlfo_spare = NULL;
+      atomic_store_release (&_dlfo_tables[(version + 1) & 1], target);
+    }
+
+  /* See dlfo_add.  */
+  atomic_thread_fence_release ();
+
+  size_t k = 0;
+  for (size_t i = 0; i < active->size; ++i)
+    if (!active->entries[i].map->l_removed)
+      dlfo_store (&target->entries[k++], &active->entries[i]);
+  dlfo_publish (k);
+}
+
+int
+_dl_find_object (void *pc, struct dl_find_object *result)
+{
+  uintptr_t addr = (uintptr_t) pc;
+
+  while (true)
+    {
+      unsigned int version = atomic_load_acquire (&_dlfo_version);
+      struct dlfo_table *table
+	= atomic_load_acquire (&_dlfo_tables[version & 1]);
+
+      struct dlfo_entry found = { .map = NULL };
+      if (table != NULL)
+	{
+	  /* The size may be inconsistent if the writer is active, but
+	     it must never cause an out-of-bounds access.  */
+	  size_t size = atomic_load_relaxed (&table->size);
+	  if (size > table->allocated)
+	    size = table->allocated;
+
+	  /* Find the first entry which starts after ADDR.  */
+	  size_t lo = 0;
+	  size_t hi = size;
+	  while (lo < hi)
+	    {
+	      size_t mid = lo + (hi - lo) / 2;
+	      if (atomic_load_relaxed (&table->entries[mid].map_start) <= addr)
+		lo = mid + 1;
+	      else
+		hi = mid;
+	    }
+
+	  if (lo > 0)
+	    {
+	      struct dlfo_entry *e = &table->entries[lo - 1];
+	      found.map_start = atomic_load_relaxed (&e->map_start);
+	      found.map_end = atomic_load_relaxed (&e->map_end);
+	      found.map = atomic_load_relaxed (&e->map);
+	      found.eh_frame = atomic_load_relaxed (&e->eh_frame);
+	    }
+	}
+
+      /* Pairs with the release fence in dlfo_add and
+	 _dl_find_object_dlclose.  */
+      atomic_thread_fence_acquire ();
+      if (atomic_load_relaxed (&_dlfo_version) != version)
+	/* The table was modified during the lookup.  */
+	continue;
+
+      if (found.map == NULL || addr < found.map_start
+	  || addr >= found.map_end)
+	return -1;
+
+      result->dlfo_flags = 0;
+      result->dlfo_map_start = (void *) found.map_start;
+      result->dlfo_map_end = (void *) found.map_end;
+      result->dlfo_link_map = found.map;
+      result->dlfo_eh_frame = found.eh_frame;
+      return 0;
+    }
+}
+rtld_hidden_def (_dl_find_object)
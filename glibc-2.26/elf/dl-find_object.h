@@ -0,0 +1,42 @@
+/* Internal interfaces of the _dl_find_object address index.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_FIND_OBJECT_H
+#define _DL_FIND_OBJECT_H
+
+#include <link.h>
+#include <stdbool.h>
+
+/* Build the initial index from all objects loaded at program start.
+   Must be called after the objects have been mapped and before any
+   additional thread is created.  Terminates the process on memory
+   allocation failure.  */
+extern void _dl_find_object_init (void) attribute_hidden;
+
+/* Add all objects in the namespace of NEW which are not yet part of
+   the index.  Called by dlopen with GL(dl_load_lock) held.  Returns
+   false if memory could not be allocated, in which case the index is
+   left unchanged.  */
+extern bool _dl_find_object_update (struct link_map *new) attribute_hidden;
+
+/* Remove all objects which have been marked with l_removed from the
+   index.  Called by dlclose with GL(dl_load_lock) held, before the
+   objects are unmapped.  Cannot fail.  */
+extern void _dl_find_object_dlclose (void) attribute_hidden;
+
+#endif /* _DL_FIND_OBJECT_H */
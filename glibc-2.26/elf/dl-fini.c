@@ -271,7 +271,10 @@ _dl_fini (void)
       goto again;
     }
 
-  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+  /* The JSON output consists only of the reports.  */
+  if (__glibc_unlikely ((GLRO(dl_debug_mask)
+			 & (DL_DEBUG_STATISTICS | DL_DEBUG_JSON))
+			== DL_DEBUG_STATISTICS))
     _dl_debug_printf ("\nruntime linker statistics:\n"
 		      "           final number of relocations: %lu\n"
 		      "final number of relocations from cache: %lu\n",
@@ -0,0 +1,35 @@
+/* Huge page backing for the text of shared objects.  Generic version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldsodefs.h>
+#include <dl-hugepage.h>
+
+/* Object text is always mapped with the normal page size on this
+   system.  */
+
+size_t
+_dl_hugepage_text_align (ElfW(Addr) start, ElfW(Addr) end, ElfW(Off) offset,
+			 ElfW(Addr) *residue)
+{
+  return 0;
+}
+
+void
+_dl_hugepage_text_setup (ElfW(Addr) start, ElfW(Addr) end)
+{
+}
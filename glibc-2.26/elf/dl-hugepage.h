@@ -0,0 +1,41 @@
+/* Huge page backing for the text of shared objects.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_HUGEPAGE_H
+#define _DL_HUGEPAGE_H
+
+#include <link.h>
+#include <stddef.h>
+
+/* Decide whether the executable segment which covers [START, END) of
+   the address space of a position-independent object and is mapped
+   from file offset OFFSET should be backed by huge pages, as requested
+   by the glibc.rtld.hugepage_text tunable.  If so, return the huge page
+   size and store in *RESIDUE the value which the load bias of the
+   object must have modulo the huge page size.  Otherwise return 0.  */
+extern size_t _dl_hugepage_text_align (ElfW(Addr) start, ElfW(Addr) end,
+				       ElfW(Off) offset, ElfW(Addr) *residue)
+     attribute_hidden;
+
+/* Back the executable segment at [START, END), which has been mapped
+   at a load bias satisfying the constraint from _dl_hugepage_text_align,
+   with huge pages where possible.  Failures are ignored.  */
+extern void _dl_hugepage_text_setup (ElfW(Addr) start, ElfW(Addr) end)
+     attribute_hidden;
+
+#endif /* _DL_HUGEPAGE_H */
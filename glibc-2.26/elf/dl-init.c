@@ -50,6 +50,12 @@ call_init (struct link_map *l, int argc, char **argv, char **env)
     _dl_debug_printf ("\ncalling init: %s\n\n",
 		      DSO_FILENAME (l->l_name));
 
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  hp_timing_t start_time = 0;
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    HP_TIMING_NOW (start_time);
+#endif
+
   /* Now run the local constructors.  There are two forms of them:
      - the one named by DT_INIT
      - the others in the DT_INIT_ARRAY.
@@ -71,6 +77,15 @@ call_init (struct link_map *l, int argc, char **argv, char **env)
       for (j = 0; j < jm; ++j)
 	((init_t) addrs[j]) (argc, argv, env);
     }
+
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    {
+      hp_timing_t stop_time;
+      HP_TIMING_NOW (stop_time);
+      HP_TIMING_DIFF (l->l_stats.init_time, start_time, stop_time);
+    }
+#endif
 }
 
 
@@ -115,10 +130,40 @@ _dl_init (struct link_map *main_map, int argc, char **argv, char **env)
      loader which has to find the dependencies at runtime instead of
      letting the user do it right.  Stupidity rules!  */
 
+#ifdef SHARED
+  /* When called for the initially loaded objects, print the time spent
+     in their constructors.  dlopen reports it for new objects.  */
+  bool startup = (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS)
+		  && main_map == GL(dl_ns)[LM_ID_BASE]._ns_loaded
+		  && !main_map->l_init_called);
+# ifndef HP_TIMING_NONAVAIL
+  hp_timing_t start_time = 0;
+  if (startup)
+    HP_TIMING_NOW (start_time);
+# endif
+#endif
+
   i = main_map->l_searchlist.r_nlist;
   while (i-- > 0)
     call_init (main_map->l_initfini[i], argc, argv, env);
 
+#ifdef SHARED
+  if (startup)
+    {
+      struct dl_statistics stats =
+	{
+	  .event = dl_statistics_init,
+	  .nsid = LM_ID_BASE
+	};
+# ifndef HP_TIMING_NONAVAIL
+      hp_timing_t stop_time;
+      HP_TIMING_NOW (stop_time);
+      HP_TIMING_DIFF (stats.total_time, start_time, stop_time);
+# endif
+      _dl_statistics_report (&stats);
+    }
+#endif
+
 #ifndef HAVE_INLINED_SYSCALLS
   /* Finished starting up.  */
   _dl_starting_up = 0;
@@ -38,6 +38,7 @@
 #include <stap-probe.h>
 #include <libc-pointer-arith.h>
 
+#include <dl-dircache.h>
 #include <dl-dst.h>
 #include <dl-load.h>
 #include <dl-map-segments.h>
@@ -1753,6 +1754,16 @@ open_path (const char *name, size_t namelen, int mode,
        given on the command line when rtld is run directly.  */
     return -1;
 
+  /* The directory contents cache is not used when auditing is active,
+     because the auditing code may change the names which are tried,
+     and not when loading auditing code, for the same reason the
+     directory status is not updated for it below.  */
+  bool use_dircache = (loader == NULL
+		       || GL(dl_ns)[loader->l_ns]._ns_loaded->l_auditing == 0);
+#ifdef SHARED
+  use_dircache &= GLRO(dl_naudit) == 0;
+#endif
+
   buf = alloca (max_dirnamelen + max_capstrlen + namelen);
   do
     {
@@ -1779,15 +1790,33 @@ open_path (const char *name, size_t namelen, int mode,
 	  if (this_dir->status[cnt] == nonexisting)
 	    continue;
 
-	  buflen =
-	    ((char *) __mempcpy (__mempcpy (edp, capstr[cnt].str,
-					    capstr[cnt].len),
-				 name, namelen)
-	     - buf);
+	  char *namep = __mempcpy (edp, capstr[cnt].str, capstr[cnt].len);
+
+	  /* Skip the open call if the directory is known not to contain
+	     the file.  */
+	  bool may_exist = true;
+	  if (use_dircache)
+	    {
+	      *namep = '\0';
+	      may_exist = _dl_dircache_may_exist (this_dir, cnt, buf,
+						  name, namelen);
+	    }
+
+	  buflen = (char *) __mempcpy (namep, name, namelen) - buf;
 
 	  /* Print name we try if this is wanted.  */
 	  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
-	    _dl_debug_printf ("  trying file=%s\n", buf);
+	    _dl_debug_printf ("  trying file=%s%s\n", buf,
+			      may_exist ? "" : " (not in directory)");
+
+	  if (!may_exist)
+	    {
+	      /* The directory has been read, so it exists.  */
+	      this_dir->status[cnt] = existing;
+	      here_any = 1;
+	      __set_errno (ENOENT);
+	      continue;
+	    }
 
 	  fd = open_verify (buf, -1, fbp, loader, whatcode, mode,
 			    found_other_class, false);
@@ -1931,6 +1960,12 @@ _dl_map_object (struct link_map *loader, const char *name,
       return l;
     }
 
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  hp_timing_t start_time = 0;
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    HP_TIMING_NOW (start_time);
+#endif
+
   /* Display information if we are debugging.  */
   if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES)
       && loader != NULL)
@@ -1983,10 +2018,13 @@ _dl_map_object (struct link_map *loader, const char *name,
       /* Search for NAME in several places.  */
 
       size_t namelen = strlen (name) + 1;
+      bool retried = false;
 
       if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
 	_dl_debug_printf ("find library=%s [%lu]; searching\n", name, nsid);
 
+      _dl_dircache_new_search ();
+    search:
       fd = -1;
 
       /* When the object has the RUNPATH information we don't use any
@@ -2120,6 +2158,17 @@ _dl_map_object (struct link_map *loader, const char *name,
 	fd = open_path (name, namelen, mode, &rtld_search_dirs,
 			&realname, &fb, l, LA_SER_DEFAULT, &found_other_class);
 
+      /* Directories are only read once per dlopen call, so a file may
+	 have been skipped which was created in the same clock tick the
+	 directory has been read.  Search again, after reading the
+	 directories in which the file was skipped once more, before
+	 giving up.  */
+      if (fd == -1 && !retried && _dl_dircache_refresh_skipped ())
+	{
+	  retried = true;
+	  goto search;
+	}
+
       /* Add another newline when we are tracing the library loading.  */
       if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
 	_dl_debug_printf ("\n");
@@ -2196,8 +2245,22 @@ _dl_map_object (struct link_map *loader, const char *name,
     }
 
   void *stack_end = __libc_stack_end;
-  return _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
-				 type, mode, &stack_end, nsid);
+  l = _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
+			      type, mode, &stack_end, nsid);
+
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  /* The time includes the search for the file.  An object which was
+     already loaded under a different name has its time set.  */
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS)
+      && l != NULL && l->l_stats.map_time == 0)
+    {
+      hp_timing_t stop_time;
+      HP_TIMING_NOW (stop_time);
+      HP_TIMING_DIFF (l->l_stats.map_time, start_time, stop_time);
+    }
+#endif
+
+  return l;
 }
 
 struct add_path_state
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <ldsodefs.h>
 #include <dl-hash.h>
 #include <dl-machine.h>
@@ -28,6 +29,7 @@
 #include <libc-lock.h>
 #include <tls.h>
 #include <atomic.h>
+#include <libc-pointer-arith.h>
 
 #include <assert.h>
 
@@ -794,19 +796,204 @@ _dl_debug_bindings (const char *undef_name, struct link_map *undef_map,
 		    int protected);
 
 
+#ifdef SHARED
+/* Memoized results of symbol lookups in the global scope while the
+   initially loaded objects are relocated.  The same symbols are
+   typically referenced from many objects, and each reference would
+   otherwise walk the whole scope again.  The table is shared with the
+   relocation helper threads: slots are claimed with a CAS on STATE and
+   published with a release store, and a reader which finds a slot that
+   is still being written simply treats the lookup as a miss.  */
+struct lookup_memo_entry
+{
+  unsigned int state;
+  uint32_t hash;
+  int type_class;
+  int flags;
+  const char *name;
+  const struct r_found_version *version;
+  struct sym_val value;
+};
+
+enum
+  {
+    lookup_memo_empty,
+    lookup_memo_busy,
+    lookup_memo_valid
+  };
+
+/* Bounds for the number of slots in the table.  */
+# define LOOKUP_MEMO_MIN_SIZE 1024
+# define LOOKUP_MEMO_MAX_SIZE (1 << 18)
+/* Give up after this many probes.  */
+# define LOOKUP_MEMO_MAX_PROBES 32
+
+static struct lookup_memo_entry *lookup_memo;
+static size_t lookup_memo_size;
+static size_t lookup_memo_mapsize;
+static unsigned int lookup_memo_count;
+static struct r_scope_elem *lookup_memo_scope;
+
+void
+_dl_lookup_memo_start (struct link_map *main_map)
+{
+  /* The debugging output lists every object searched.  */
+  if (GLRO(dl_debug_mask) & (DL_DEBUG_SYMBOLS | DL_DEBUG_PRELINK))
+    return;
+
+  /* Estimate the number of symbolic relocations.  This overestimates
+     for RELA relocations, which is fine for sizing the table.  */
+  size_t nrelocs = 0;
+  for (unsigned int i = 0; i < main_map->l_searchlist.r_nlist; ++i)
+    {
+      struct link_map *l = main_map->l_searchlist.r_list[i];
+      if (l->l_info[DT_RELSZ] != NULL)
+	nrelocs += l->l_info[DT_RELSZ]->d_un.d_val;
+      if (l->l_info[DT_RELASZ] != NULL)
+	nrelocs += l->l_info[DT_RELASZ]->d_un.d_val;
+      if (l->l_info[DT_PLTRELSZ] != NULL)
+	nrelocs += l->l_info[DT_PLTRELSZ]->d_un.d_val;
+    }
+  nrelocs /= sizeof (ElfW(Rel));
+
+  size_t size = LOOKUP_MEMO_MIN_SIZE;
+  while (size < 2 * nrelocs && size < LOOKUP_MEMO_MAX_SIZE)
+    size *= 2;
+
+  size_t mapsize = ALIGN_UP (size * sizeof (struct lookup_memo_entry),
+			     GLRO(dl_pagesize));
+  void *p = __mmap (NULL, mapsize, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    return;
+
+  lookup_memo = p;
+  lookup_memo_size = size;
+  lookup_memo_mapsize = mapsize;
+  lookup_memo_count = 0;
+  lookup_memo_scope = &main_map->l_searchlist;
+}
+
+void
+_dl_lookup_memo_end (void)
+{
+  if (lookup_memo != NULL)
+    {
+      __munmap (lookup_memo, lookup_memo_mapsize);
+      lookup_memo = NULL;
+    }
+  lookup_memo_scope = NULL;
+}
+
+void
+_dl_lookup_memo_disable (void)
+{
+  atomic_store_relaxed (&lookup_memo_scope, NULL);
+}
+
+static inline uint32_t
+lookup_memo_hash (uint_fast32_t new_hash,
+		  const struct r_found_version *version, int type_class)
+{
+  uint32_t hash = new_hash;
+  if (version != NULL)
+    hash ^= version->hash * 31;
+  return hash * 33 + type_class;
+}
+
+static inline bool
+lookup_memo_match (const struct lookup_memo_entry *e, uint32_t hash,
+		   const char *undef_name,
+		   const struct r_found_version *version,
+		   int type_class, int flags)
+{
+  if (e->hash != hash || e->type_class != type_class || e->flags != flags
+      || strcmp (e->name, undef_name) != 0)
+    return false;
+  if (e->version == version)
+    return true;
+  if (e->version == NULL || version == NULL)
+    return false;
+  /* The version requirement, including the file name, is copied from
+     the referencing object, so different objects have different
+     structures for the same requirement.  */
+  return (e->version->hash == version->hash
+	  && e->version->hidden == version->hidden
+	  && strcmp (e->version->name, version->name) == 0
+	  && (e->version->filename == version->filename
+	      || (e->version->filename != NULL && version->filename != NULL
+		  && strcmp (e->version->filename, version->filename) == 0)));
+}
+
+static bool
+lookup_memo_find (uint32_t hash, const char *undef_name,
+		  const struct r_found_version *version, int type_class,
+		  int flags, struct sym_val *result)
+{
+  size_t mask = lookup_memo_size - 1;
+  size_t idx = hash & mask;
+  for (int n = 0; n < LOOKUP_MEMO_MAX_PROBES; ++n, idx = (idx + 1) & mask)
+    {
+      struct lookup_memo_entry *e = &lookup_memo[idx];
+      unsigned int state = atomic_load_acquire (&e->state);
+      if (state == lookup_memo_empty)
+	return false;
+      if (state == lookup_memo_valid
+	  && lookup_memo_match (e, hash, undef_name, version, type_class,
+				flags))
+	{
+	  *result = e->value;
+	  return true;
+	}
+    }
+  return false;
+}
+
+static void
+lookup_memo_add (uint32_t hash, const char *undef_name,
+		 const struct r_found_version *version, int type_class,
+		 int flags, const struct sym_val *value)
+{
+  /* Keep the table at most three quarters full.  */
+  if (atomic_fetch_add_relaxed (&lookup_memo_count, 1)
+      >= lookup_memo_size / 4 * 3)
+    return;
+
+  size_t mask = lookup_memo_size - 1;
+  size_t idx = hash & mask;
+  for (int n = 0; n < LOOKUP_MEMO_MAX_PROBES; ++n, idx = (idx + 1) & mask)
+    {
+      struct lookup_memo_entry *e = &lookup_memo[idx];
+      unsigned int expected = lookup_memo_empty;
+      if (atomic_load_relaxed (&e->state) == lookup_memo_empty
+	  && atomic_compare_exchange_weak_acquire (&e->state, &expected,
+						   lookup_memo_busy))
+	{
+	  e->hash = hash;
+	  e->type_class = type_class;
+	  e->flags = flags;
+	  e->name = undef_name;
+	  e->version = version;
+	  e->value = *value;
+	  atomic_store_release (&e->state, lookup_memo_valid);
+	  return;
+	}
+    }
+}
+#endif
+
 /* Search loaded objects' symbol tables for a definition of the symbol
    UNDEF_NAME, perhaps with a requested version for the symbol.
 
    We must never have calls to the audit functions inside this function
    or in any function which gets called.  If this would happen the audit
    code might create a thread which can throw off all the scope locking.  */
-lookup_t
-internal_function
-_dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
-		     const ElfW(Sym) **ref,
-		     struct r_scope_elem *symbol_scope[],
-		     const struct r_found_version *version,
-		     int type_class, int flags, struct link_map *skip_map)
+static lookup_t
+__attribute_noinline__
+lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
+		 const ElfW(Sym) **ref, struct r_scope_elem *symbol_scope[],
+		 const struct r_found_version *version,
+		 int type_class, int flags, struct link_map *skip_map)
 {
   const uint_fast32_t new_hash = dl_new_hash (undef_name);
   unsigned long int old_hash = 0xffffffff;
@@ -821,6 +1008,25 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
 	  || (flags & ~(DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_GSCOPE_LOCK))
 	     == 0);
 
+#ifdef SHARED
+  /* The result of the scope walk only depends on the arguments which
+     are part of the key, except for lookups skipping an object and the
+     protected data lookups without UNDEF_MAP.  */
+  struct r_scope_elem *memo_scope = atomic_load_relaxed (&lookup_memo_scope);
+  bool use_memo = (memo_scope != NULL
+		   && skip_map == NULL && undef_map != NULL
+		   && symbol_scope[0] == memo_scope
+		   && symbol_scope[1] == NULL);
+  uint32_t memo_hash = 0;
+  if (use_memo)
+    {
+      memo_hash = lookup_memo_hash (new_hash, version, type_class);
+      if (lookup_memo_find (memo_hash, undef_name, version, type_class,
+			    flags, &current_value))
+	goto found;
+    }
+#endif
+
   size_t i = 0;
   if (__glibc_unlikely (skip_map != NULL))
     /* Search the relevant loaded objects for a definition.  */
@@ -859,6 +1065,16 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
 	}
     }
 
+#ifdef SHARED
+  /* Unique symbols are resolved through a separate table whose state
+     depends on the first reference.  */
+  if (use_memo && current_value.s != NULL
+      && ELFW(ST_BIND) (current_value.s->st_info) != STB_GNU_UNIQUE)
+    lookup_memo_add (memo_hash, undef_name, version, type_class, flags,
+		     &current_value);
+
+ found:
+#endif
   if (__glibc_unlikely (current_value.s == NULL))
     {
       if ((*ref == NULL || ELFW(ST_BIND) ((*ref)->st_info) != STB_WEAK)
@@ -929,10 +1145,10 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
       && add_dependency (undef_map, current_value.m, flags) < 0)
       /* Something went wrong.  Perhaps the object we tried to reference
 	 was just removed.  Try finding another definition.  */
-      return _dl_lookup_symbol_x (undef_name, undef_map, ref,
-				  (flags & DL_LOOKUP_GSCOPE_LOCK)
-				  ? undef_map->l_scope : symbol_scope,
-				  version, type_class, flags, skip_map);
+      return lookup_symbol_x (undef_name, undef_map, ref,
+			      (flags & DL_LOOKUP_GSCOPE_LOCK)
+			      ? undef_map->l_scope : symbol_scope,
+			      version, type_class, flags, skip_map);
 
   /* The object is used.  */
   if (__glibc_unlikely (current_value.m->l_used == 0))
@@ -947,6 +1163,40 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
   return LOOKUP_VALUE (current_value.m);
 }
 
+lookup_t
+internal_function
+_dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
+		     const ElfW(Sym) **ref,
+		     struct r_scope_elem *symbol_scope[],
+		     const struct r_found_version *version,
+		     int type_class, int flags, struct link_map *skip_map)
+{
+#ifdef SHARED
+  /* Account the lookup to the object containing the reference.  The
+     counters are not updated atomically, so they are only approximate
+     if several threads resolve symbols for the same object.  */
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS)
+      && undef_map != NULL)
+    {
+      ++undef_map->l_stats.num_lookups;
+# ifndef HP_TIMING_NONAVAIL
+      hp_timing_t start, stop, diff;
+      HP_TIMING_NOW (start);
+      lookup_t result = lookup_symbol_x (undef_name, undef_map, ref,
+					 symbol_scope, version, type_class,
+					 flags, skip_map);
+      HP_TIMING_NOW (stop);
+      HP_TIMING_DIFF (diff, start, stop);
+      HP_TIMING_ACCUM_NT (undef_map->l_stats.lookup_time, diff);
+      return result;
+# endif
+    }
+#endif
+
+  return lookup_symbol_x (undef_name, undef_map, ref, symbol_scope,
+			  version, type_class, flags, skip_map);
+}
+
 
 /* Cache the location of MAP's hash table.  */
 
@@ -17,6 +17,44 @@
    <http://www.gnu.org/licenses/>.  */
 
 #include <dl-load.h>
+#include <dl-hugepage.h>
+#include <dl-prefault.h>
+#include <libc-pointer-arith.h>
+
+/* Map the first segment C of an object like _dl_map_segments, extended
+   to MAPLENGTH bytes, at an address which is congruent to RESIDUE
+   modulo ALIGN.  */
+static __always_inline ElfW(Addr)
+_dl_map_segment_aligned (const struct loadcmd *c, size_t maplength,
+                         size_t align, ElfW(Addr) residue, int fd)
+{
+  /* Reserve enough address space to find a suitable address in it.  */
+  size_t reserve = maplength + align;
+  ElfW(Addr) start = (ElfW(Addr)) __mmap (NULL, reserve, PROT_NONE,
+                                          MAP_ANON|MAP_PRIVATE, -1, 0);
+  if (__glibc_unlikely ((void *) start == MAP_FAILED))
+    return start;
+
+  ElfW(Addr) mapstart = start + ((residue - start) & (align - 1));
+  ElfW(Addr) result = (ElfW(Addr)) __mmap ((void *) mapstart, maplength,
+                                           c->prot,
+                                           MAP_COPY|MAP_FILE|MAP_FIXED,
+                                           fd, c->mapoff);
+  if (__glibc_unlikely ((void *) result == MAP_FAILED))
+    {
+      __munmap ((void *) start, reserve);
+      return result;
+    }
+
+  /* Release the unused parts of the reservation.  */
+  if (mapstart > start)
+    __munmap ((void *) start, mapstart - start);
+  ElfW(Addr) mapend = ALIGN_UP (mapstart + maplength, GLRO(dl_pagesize));
+  if (start + reserve > mapend)
+    __munmap ((void *) mapend, start + reserve - mapend);
+
+  return result;
+}
 
 /* This implementation assumes (as does the corresponding implementation
    of _dl_unmap_segments, in dl-unmap-segments.h) that shared objects
@@ -33,6 +71,8 @@ _dl_map_segments (struct link_map *l, int fd,
                   struct link_map *loader)
 {
   const struct loadcmd *c = loadcmds;
+  /* The executable segment to back with huge pages, if any.  */
+  const struct loadcmd *text = NULL;
 
   if (__glibc_likely (type == ET_DYN))
     {
@@ -52,11 +92,31 @@ _dl_map_segments (struct link_map *l, int fd,
                                   c->mapstart & GLRO(dl_use_load_bias))
            - MAP_BASE_ADDR (l));
 
+      /* If huge pages have been requested for the text of large
+         objects, the object has to be mapped at a suitably aligned
+         address instead.  */
+      size_t align = 0;
+      ElfW(Addr) residue = 0;
+      for (const struct loadcmd *t = loadcmds; t < &loadcmds[nloadcmds]; ++t)
+        if ((t->prot & PROT_EXEC) != 0
+            && (text == NULL
+                || t->mapend - t->mapstart > text->mapend - text->mapstart))
+          text = t;
+      if (text != NULL)
+        align = _dl_hugepage_text_align (text->mapstart, text->mapend,
+                                         text->mapoff, &residue);
+      if (__glibc_likely (align == 0))
+        text = NULL;
+
       /* Remember which part of the address space this object uses.  */
-      l->l_map_start = (ElfW(Addr)) __mmap ((void *) mappref, maplength,
-                                            c->prot,
-                                            MAP_COPY|MAP_FILE,
-                                            fd, c->mapoff);
+      if (__glibc_unlikely (text != NULL))
+        l->l_map_start = _dl_map_segment_aligned (c, maplength, align,
+                                                  residue + c->mapstart, fd);
+      else
+        l->l_map_start = (ElfW(Addr)) __mmap ((void *) mappref, maplength,
+                                              c->prot,
+                                              MAP_COPY|MAP_FILE,
+                                              fd, c->mapoff);
       if (__glibc_unlikely ((void *) l->l_map_start == MAP_FAILED))
         return DL_MAP_SEGMENTS_ERROR_MAP_SEGMENT;
 
@@ -149,6 +209,18 @@ _dl_map_segments (struct link_map *l, int fd,
       ++c;
     }
 
+  if (__glibc_unlikely (text != NULL))
+    _dl_hugepage_text_setup (l->l_addr + text->mapstart,
+                             l->l_addr + text->mapend);
+
+  /* Only the file-backed part of the segments is prefaulted; the pages
+     of the zero-filled part are allocated when they are used.  */
+  int prefault = _dl_prefault_mode (l->l_name);
+  if (__glibc_unlikely (prefault != 0))
+    for (const struct loadcmd *p = loadcmds; p < &loadcmds[nloadcmds]; ++p)
+      _dl_prefault_segment (l->l_addr + p->mapstart, l->l_addr + p->dataend,
+                            p->prot, prefault);
+
   /* Notify ELF_PREFERRED_ADDRESS that we have to load this one
      fixed.  */
   ELF_FIXED_ADDRESS (loader, c->mapstart);
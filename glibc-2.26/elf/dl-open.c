@@ -32,6 +32,8 @@
 #include <sysdep-cancel.h>
 #include <tls.h>
 #include <stap-probe.h>
+#include <dl-dircache.h>
+#include <dl-find_object.h>
 #include <atomic.h>
 
 #include <dl-dst.h>
@@ -275,6 +277,14 @@ dl_open_worker (void *a)
       (void) _dl_check_map_versions (new->l_searchlist.r_list[i]->l_real,
 				     0, 0);
 
+  /* Make the new objects known to _dl_find_object.  This has to happen
+     before relocation because IFUNC resolvers and ELF constructors may
+     already throw exceptions.  On failure, the objects are removed
+     again by the dlclose performed in _dl_open.  */
+  if (!_dl_find_object_update (new))
+    _dl_signal_error (ENOMEM, new->l_libname->name, NULL,
+		      N_("cannot allocate address lookup data"));
+
 #ifdef SHARED
   /* Auditing checkpoint: we have added all objects.  */
   if (__glibc_unlikely (GLRO(dl_naudit) > 0))
@@ -385,6 +395,17 @@ dl_open_worker (void *a)
 	}
     }
 
+  /* Place the TLS blocks of the new objects into the optional part of
+     the static TLS surplus while there is room, so that accessing them
+     does not require a lazy allocation in __tls_get_addr.  This is done
+     before relocation so that TLS descriptors use the static model.
+     The blocks are initialized below, together with those of objects
+     which require static TLS.  */
+  for (size_t i = nmaps; i-- > 0; )
+    if (maps[i]->l_tls_blocksize > 0
+	&& maps[i]->l_tls_offset == NO_TLS_OFFSET)
+      (void) _dl_try_allocate_optional_static_tls (maps[i]);
+
   int relocation_in_progress = 0;
 
   for (size_t i = nmaps; i-- > 0; )
@@ -422,6 +443,11 @@ dl_open_worker (void *a)
       else
 #endif
 	_dl_relocate_object (l, l->l_scope, reloc_mode, 0);
+
+#ifdef SHARED
+      if (__glibc_unlikely (_dl_profile_sampling))
+	_dl_profile_sample_add (l);
+#endif
     }
 
   /* If the file is not loaded now as a dependency, add the search
@@ -523,10 +549,17 @@ dl_open_worker (void *a)
 	_dl_show_scope (imap, from_scope);
     }
 
-  /* Bump the generation number if necessary.  */
-  if (any_tls && __builtin_expect (++GL(dl_tls_generation) == 0, 0))
-    _dl_fatal_printf (N_("\
+  /* Bump the generation number if necessary.  The release store makes
+     the slotinfo entries added above visible to _dl_update_slotinfo in
+     threads which observe the new generation.  */
+  if (any_tls)
+    {
+      size_t newgen = GL(dl_tls_generation) + 1;
+      if (__glibc_unlikely (newgen == 0))
+	_dl_fatal_printf (N_("\
 TLS generation counter wrapped!  Please report this."));
+      atomic_store_release (&GL(dl_tls_generation), newgen);
+    }
 
   /* We need a second pass for static tls data, because _dl_update_slotinfo
      must not be run while calls to _dl_add_to_slotinfo are still pending.  */
@@ -643,6 +676,27 @@ no more namespaces available for dlmopen()"));
   args.argv = argv;
   args.env = env;
 
+  /* Check cached directory contents again before they are used in
+     this call.  */
+  _dl_dircache_new_generation ();
+
+#ifdef SHARED
+  /* An IFUNC resolver may call dlopen while the initially loaded
+     objects are being relocated.  The new objects can change the
+     results of lookups in the global scope.  */
+  _dl_lookup_memo_disable ();
+#endif
+
+#ifdef SHARED
+  unsigned long int num_relocations = GL(dl_num_relocations);
+  unsigned long int num_cache_relocations = GL(dl_num_cache_relocations);
+# ifndef HP_TIMING_NONAVAIL
+  hp_timing_t start_time = 0;
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    HP_TIMING_NOW (start_time);
+# endif
+#endif
+
   const char *objname;
   const char *errstring;
   bool malloced;
@@ -650,8 +704,8 @@ no more namespaces available for dlmopen()"));
 				 dl_open_worker, &args);
 
 #if defined USE_LDCONFIG && !defined MAP_COPY
-  /* We must unmap the cache file.  */
-  _dl_unload_cache ();
+  /* The cache file may be replaced before the next dlopen.  */
+  _dl_release_cache ();
 #endif
 
   /* See if an error occurred during loading.  */
@@ -705,6 +759,29 @@ no more namespaces available for dlmopen()"));
 
   assert (_dl_debug_initialize (0, args.nsid)->r_state == RT_CONSISTENT);
 
+#ifdef SHARED
+  /* Print the statistics for the objects loaded by this call.  */
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS)
+      && args.map != NULL)
+    {
+      struct dl_statistics stats =
+	{
+	  .event = dl_statistics_dlopen,
+	  .file = file,
+	  .nsid = args.map->l_ns,
+	  .num_relocations = GL(dl_num_relocations) - num_relocations,
+	  .num_cache_relocations = (GL(dl_num_cache_relocations)
+				    - num_cache_relocations)
+	};
+# ifndef HP_TIMING_NONAVAIL
+      hp_timing_t stop_time;
+      HP_TIMING_NOW (stop_time);
+      HP_TIMING_DIFF (stats.total_time, start_time, stop_time);
+# endif
+      _dl_statistics_report (&stats);
+    }
+#endif
+
   /* Release the lock.  */
   __rtld_lock_unlock_recursive (GL(dl_load_lock));
 
@@ -0,0 +1,138 @@
+/* Prefaulting of object segments at load time.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <dl-prefault.h>
+
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
+
+/* The values of the glibc.rtld.prefault tunable.  With
+   prefault_readahead, the kernel is asked to read the file-backed
+   pages of each segment into the page cache right away, so that later
+   accesses do not cause major page faults.  With prefault_populate,
+   every page is also accessed once, so that the page table entries
+   exist and the private copies of writable pages are made before the
+   object is used.  */
+enum
+  {
+    prefault_disabled = 0,
+    prefault_readahead = 1,
+    prefault_populate = 2
+  };
+
+static int mode = -1;
+
+/* The comma-separated list of objects from the
+   glibc.rtld.prefault_objects tunable, or NULL if all objects are
+   prefaulted.  */
+static const char *objects;
+
+static void
+init_mode (void)
+{
+  int32_t value = prefault_disabled;
+#if HAVE_TUNABLES
+  value = TUNABLE_GET (prefault, int32_t, NULL);
+  if (value != prefault_disabled)
+    {
+      objects = TUNABLE_GET (prefault_objects, const char *, NULL);
+      if (objects != NULL && *objects == '\0')
+	objects = NULL;
+    }
+#endif
+  mode = value;
+}
+
+/* Return true if NAME matches one of the entries of OBJECTS, either
+   as a whole or in its last component.  */
+static bool
+object_selected (const char *name)
+{
+  const char *base = strrchr (name, '/');
+  base = base != NULL ? base + 1 : name;
+  size_t namelen = strlen (name);
+  size_t baselen = strlen (base);
+
+  const char *p = objects;
+  while (*p != '\0')
+    {
+      const char *end = p;
+      while (*end != '\0' && *end != ',')
+	++end;
+      size_t len = end - p;
+      if (len != 0
+	  && ((len == namelen && memcmp (p, name, len) == 0)
+	      || (len == baselen && memcmp (p, base, len) == 0)))
+	return true;
+      p = *end == ',' ? end + 1 : end;
+    }
+  return false;
+}
+
+int
+_dl_prefault_mode (const char *name)
+{
+  if (__glibc_unlikely (mode < 0))
+    init_mode ();
+  if (__glibc_likely (mode == prefault_disabled))
+    return prefault_disabled;
+
+  if (objects != NULL && (name == NULL || !object_selected (name)))
+    return prefault_disabled;
+  return mode;
+}
+
+void
+_dl_prefault_segment (ElfW(Addr) start, ElfW(Addr) end, int prot,
+		      int level)
+{
+  size_t pagesize = GLRO(dl_pagesize);
+  start = ALIGN_DOWN (start, pagesize);
+  end = ALIGN_UP (end, pagesize);
+  if (start >= end)
+    return;
+
+#ifdef MADV_WILLNEED
+  /* Start reading the whole segment at once, so that the accesses below
+     do not wait for a separate read of each page.  */
+  (void) __madvise ((void *) start, end - start, MADV_WILLNEED);
+#endif
+
+  if (level != prefault_populate || (prot & PROT_READ) == 0)
+    return;
+
+  /* Writing the value which is already there makes the private copy of
+     the page now.  This includes the RELRO part of the segment, which
+     therefore does not fault again when it is relocated, and stays
+     mapped when it is made read-only by _dl_protect_relro.  */
+  if ((prot & PROT_WRITE) != 0)
+    for (ElfW(Addr) p = start; p < end; p += pagesize)
+      {
+	volatile char *c = (volatile char *) p;
+	*c = *c;
+      }
+  else
+    for (ElfW(Addr) p = start; p < end; p += pagesize)
+      (void) *(volatile const char *) p;
+}
@@ -0,0 +1,35 @@
+/* Prefaulting of object segments at load time.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_PREFAULT_H
+#define _DL_PREFAULT_H
+
+#include <link.h>
+
+/* Return the value of the glibc.rtld.prefault tunable which applies
+   to the object loaded from the file NAME, or 0 if its segments are
+   not prefaulted.  */
+extern int _dl_prefault_mode (const char *name) attribute_hidden;
+
+/* Prefault the pages of the segment at [START, END), which is mapped
+   with protection PROT, as requested by LEVEL, a value returned by
+   _dl_prefault_mode.  Failures are ignored.  */
+extern void _dl_prefault_segment (ElfW(Addr) start, ElfW(Addr) end,
+				  int prot, int level) attribute_hidden;
+
+#endif /* _DL_PREFAULT_H */
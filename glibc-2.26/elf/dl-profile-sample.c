@@ -0,0 +1,328 @@
+/* Sampling profiler for the objects loaded by the dynamic linker.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <endian.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/gmon.h>
+#include <sys/time.h>
+#include <sigsetops.h>
+#include <ldsodefs.h>
+
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
+
+extern int __profile_frequency (void);
+libc_hidden_proto (__profile_frequency)
+
+/* LD_PROFILE records the call graph of a single object with mcount
+   and fills its histogram with profil, whose counters are not updated
+   atomically.  The sampling profiler instead keeps a histogram for
+   every object selected by the glibc.rtld.profile_sample tunable, in
+   the same file format, and updates it atomically from a SIGPROF
+   handler.  The ITIMER_PROF timer measures the CPU time of the whole
+   process, and the kernel sends the signal to the thread which is
+   running when it expires, so all threads are sampled.  The objects
+   do not have to be compiled with -pg.  */
+
+struct sample_object
+{
+  /* Objects are only ever added at the head of the list.  */
+  struct sample_object *next;
+  /* The object, or NULL after it has been unloaded.  */
+  struct link_map *map;
+  /* The size of the text of the object and whether the file has room
+     for call graph arcs, to reuse the histogram if an object with the
+     same NAME is loaded again.  */
+  size_t textsize;
+  bool arcs;
+  /* HIST.textsize is zero while the object is not loaded, so that the
+     signal handler ignores the entry.  */
+  struct dl_profile_hist hist;
+  char name[];
+};
+
+/* The list of sampled objects.  It is only changed while holding
+   GL(dl_load_lock) (or before other threads exist), and read by the
+   signal handler.  */
+static struct sample_object *objects;
+
+/* The value of the glibc.rtld.profile_sample tunable, a comma-separated
+   list of objects or "*" for all objects.  */
+static const char *selection;
+
+int _dl_profile_sampling;
+
+/* The counters are 16-bit values in the file, but not all
+   architectures support atomic operations on them.  */
+typedef uint32_t __attribute__ ((may_alias)) counter_word;
+
+/* Increment the counter COUNTER, unless it has reached its maximum.
+   The file can be updated by other processes at the same time.  */
+static void
+count_sample (uint16_t *counter)
+{
+  uintptr_t addr = (uintptr_t) counter;
+  counter_word *word = (counter_word *) (addr & ~(uintptr_t) 3);
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  unsigned int shift = (addr & 2) * 8;
+#else
+  unsigned int shift = 16 - (addr & 2) * 8;
+#endif
+
+  uint32_t old = atomic_load_relaxed (word);
+  do
+    if (((old >> shift) & 0xffff) == 0xffff)
+      return;
+  while (!atomic_compare_exchange_weak_relaxed (word, &old,
+						old + (1U << shift)));
+}
+
+/* Record a sample at PC in the histogram of the object which contains
+   it, if that object is sampled.  */
+static void
+sample_pc (void *pc)
+{
+  for (struct sample_object *o = atomic_load_acquire (&objects);
+       o != NULL; o = o->next)
+    {
+      size_t textsize = atomic_load_acquire (&o->hist.textsize);
+      uintptr_t offset = (uintptr_t) pc - atomic_load_relaxed (&o->hist.lowpc);
+      if (offset < textsize)
+	{
+	  count_sample (&o->hist.kcount[offset / (HISTFRACTION
+						  * sizeof (HISTCOUNTER))]);
+	  break;
+	}
+    }
+}
+
+/* Get the machine-dependent definition of the SIGPROF handler, which
+   calls profil_count with the interrupted PC.  */
+#define __profil_counter	__profile_sample_counter
+#define profil_count(pc)	sample_pc (pc)
+#include <profil-counter.h>
+
+/* Return true if the first LEN bytes of NAME are equal to the string
+   S.  */
+static bool
+name_equal (const char *name, size_t len, const char *s)
+{
+  return strlen (s) == len && memcmp (name, s, len) == 0;
+}
+
+/* Return true if NAME, which is LEN bytes long, names MAP.  */
+static bool
+name_matches (const char *name, size_t len, struct link_map *map)
+{
+  if (name_equal (name, len, map->l_name))
+    return true;
+  for (struct libname_list *lnp = map->l_libname; lnp != NULL;
+       lnp = lnp->next)
+    if (name_equal (name, len, lnp->name))
+      return true;
+
+  /* The main program is also matched by the name it has been run
+     with, with or without the directory.  */
+  if (map->l_type == lt_executable && rtld_progname != NULL)
+    {
+      const char *base = strrchr (rtld_progname, '/');
+      base = base != NULL ? base + 1 : rtld_progname;
+      return (name_equal (name, len, rtld_progname)
+	      || name_equal (name, len, base));
+    }
+  return false;
+}
+
+/* Return true if MAP is to be sampled.  */
+static bool
+selected (struct link_map *map)
+{
+  /* The object profiled by LD_PROFILE is always sampled, because
+     _dl_start_profile does not start profil while the sampling
+     profiler runs.  */
+  if (GLRO(dl_profile) != NULL && _dl_name_match_p (GLRO(dl_profile), map))
+    return true;
+
+  if (strcmp (selection, "*") == 0)
+    return true;
+
+  const char *p = selection;
+  while (*p != '\0')
+    {
+      const char *end = p;
+      while (*end != '\0' && *end != ',')
+	++end;
+      if (end > p && name_matches (p, end - p, map))
+	return true;
+      p = *end == ',' ? end + 1 : end;
+    }
+  return false;
+}
+
+/* Return the name of the profiling data file of MAP, without the
+   ".profile" suffix.  Like sprof, this uses the soname if there is
+   one.  */
+static const char *
+profile_name (struct link_map *map)
+{
+  if (map->l_info[DT_SONAME] != NULL)
+    return ((const char *) D_PTR (map, l_info[DT_STRTAB])
+	    + map->l_info[DT_SONAME]->d_un.d_val);
+
+  const char *name = map->l_name;
+  if (name[0] == '\0' && map->l_type == lt_executable)
+    name = rtld_progname;
+  if (name == NULL || name[0] == '\0')
+    return NULL;
+  const char *base = strrchr (name, '/');
+  return base != NULL ? base + 1 : name;
+}
+
+/* Return the size of the text of MAP as computed by _dl_profile_open,
+   and store its run-time start address in *LOWPC.  */
+static size_t
+text_bounds (struct link_map *map, uintptr_t *lowpc)
+{
+  ElfW(Addr) mapstart = ~((ElfW(Addr)) 0);
+  ElfW(Addr) mapend = 0;
+  for (const ElfW(Phdr) *ph = map->l_phdr;
+       ph < &map->l_phdr[map->l_phnum]; ++ph)
+    if (ph->p_type == PT_LOAD && (ph->p_flags & PF_X))
+      {
+	ElfW(Addr) start = ph->p_vaddr & ~(GLRO(dl_pagesize) - 1);
+	ElfW(Addr) end = ((ph->p_vaddr + ph->p_memsz + GLRO(dl_pagesize) - 1)
+			  & ~(GLRO(dl_pagesize) - 1));
+	if (start < mapstart)
+	  mapstart = start;
+	if (end > mapend)
+	  mapend = end;
+      }
+  if (mapend == 0)
+    return 0;
+
+  *lowpc = map->l_addr + mapstart;
+  return mapend - mapstart;
+}
+
+static void
+add_object (struct link_map *map)
+{
+#ifdef NEED_DL_SYSINFO_DSO
+  /* The vDSO has no file sprof could read.  */
+  if (map == GLRO(dl_sysinfo_map))
+    return;
+#endif
+  if (!selected (map))
+    return;
+
+  /* The histogram of the object profiled by LD_PROFILE is shared with
+     _dl_start_profile, so it has to use the same file.  */
+  const char *name;
+  bool arcs = GLRO(dl_profile) != NULL && _dl_name_match_p (GLRO(dl_profile),
+							    map);
+  if (arcs)
+    name = GLRO(dl_profile);
+  else
+    name = profile_name (map);
+  uintptr_t lowpc;
+  size_t textsize = text_bounds (map, &lowpc);
+  if (name == NULL || textsize == 0)
+    return;
+
+  struct sample_object *o;
+  for (o = objects; o != NULL; o = o->next)
+    if (o->map == NULL && o->textsize == textsize && o->arcs == arcs
+	&& strcmp (o->name, name) == 0)
+      {
+	o->map = map;
+	atomic_store_relaxed (&o->hist.lowpc, lowpc);
+	atomic_store_release (&o->hist.textsize, textsize);
+	return;
+      }
+
+  size_t namelen = strlen (name) + 1;
+  o = malloc (sizeof (*o) + namelen);
+  if (o == NULL)
+    return;
+  if (!_dl_profile_open (map, name, arcs, &o->hist))
+    {
+      free (o);
+      return;
+    }
+  o->map = map;
+  o->textsize = textsize;
+  o->arcs = arcs;
+  memcpy (o->name, name, namelen);
+  o->next = objects;
+  atomic_store_release (&objects, o);
+}
+
+void
+_dl_profile_sample_start (void)
+{
+#if HAVE_TUNABLES
+  selection = TUNABLE_GET (profile_sample, const char *, NULL);
+#endif
+  if (selection == NULL || selection[0] == '\0')
+    return;
+
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next)
+    add_object (l);
+
+  struct sigaction act;
+  act.sa_handler = (sighandler_t) &__profile_sample_counter;
+  act.sa_flags = SA_RESTART;
+  __sigfillset (&act.sa_mask);
+
+  struct itimerval timer;
+  timer.it_value.tv_sec = 0;
+  timer.it_value.tv_usec = 1000000 / __profile_frequency ();
+  timer.it_interval = timer.it_value;
+
+  if (__sigaction (SIGPROF, &act, NULL) < 0
+      || __setitimer (ITIMER_PROF, &timer, NULL) < 0)
+    {
+      _dl_error_printf ("cannot start the sampling profiler\n");
+      return;
+    }
+  _dl_profile_sampling = 1;
+}
+
+void
+_dl_profile_sample_add (struct link_map *map)
+{
+  add_object (map);
+}
+
+void
+_dl_profile_sample_remove (struct link_map *map)
+{
+  for (struct sample_object *o = objects; o != NULL; o = o->next)
+    if (o->map == map)
+      {
+	atomic_store_relaxed (&o->hist.textsize, 0);
+	o->map = NULL;
+	break;
+      }
+}
@@ -135,7 +135,7 @@ struct here_cg_arc_record
        requires it to be properly aligned for its type, and for this
        alignment to be visible to the compiler.  The amount of data
        before an array of this structure is calculated as
-       expected_size in _dl_start_profile.  Everything in that
+       expected_size in _dl_profile_open.  Everything in that
        calculation is a multiple of 4 bytes (in the case of
        kcountsize, because it is derived from a subtraction of
        page-aligned values, and the corresponding calculation in
@@ -177,11 +177,28 @@ static unsigned int log_hashfraction;
 
 
 
-/* Set up profiling data to profile object desribed by MAP.  The output
-   file is found (or created) in OUTPUT_DIR.  */
-void
+/* Return the number of arc records in the profiling data file of an
+   object with TEXTSIZE bytes of text.  */
+static uint32_t
+profile_fromlimit (size_t textsize)
+{
+  uint32_t limit = textsize * ARCDENSITY / 100;
+  if (limit < MINARCS)
+    limit = MINARCS;
+  if (limit > MAXARCS)
+    limit = MAXARCS;
+  return limit;
+}
+
+
+/* Create or open the profiling data file for the object described by
+   MAP.  The file is found (or created) in the profiling output
+   directory and its name is composed from NAME and the ending
+   ".profile".  */
+bool
 internal_function
-_dl_start_profile (void)
+_dl_profile_open (struct link_map *map, const char *name, bool arcs,
+		  struct dl_profile_hist *result)
 {
   char *filename;
   int fd;
@@ -190,22 +207,18 @@ _dl_start_profile (void)
   ElfW(Addr) mapstart = ~((ElfW(Addr)) 0);
   ElfW(Addr) mapend = 0;
   char *hist, *cp;
-  size_t idx;
-  size_t tossize;
-  size_t fromssize;
-  uintptr_t highpc;
+  uintptr_t text_start;
+  uintptr_t text_end;
+  size_t text_size;
   uint16_t *kcount;
-  size_t kcountsize;
+  size_t countsize;
+  uint32_t *arctag;
   struct gmon_hdr *addr = NULL;
   off_t expected_size;
-  /* See profil(2) where this is described.  */
-  int s_scale;
-#define SCALE_1_TO_1	0x10000L
   const char *errstr = NULL;
 
   /* Compute the size of the sections which contain program code.  */
-  for (ph = GL(dl_profile_map)->l_phdr;
-       ph < &GL(dl_profile_map)->l_phdr[GL(dl_profile_map)->l_phnum]; ++ph)
+  for (ph = map->l_phdr; ph < &map->l_phdr[map->l_phnum]; ++ph)
     if (ph->p_type == PT_LOAD && (ph->p_flags & PF_X))
       {
 	ElfW(Addr) start = (ph->p_vaddr & ~(GLRO(dl_pagesize) - 1));
@@ -220,44 +233,21 @@ _dl_start_profile (void)
 
   /* Now we can compute the size of the profiling data.  This is done
      with the same formulars as in `monstartup' (see gmon.c).  */
-  running = 0;
-  lowpc = ROUNDDOWN (mapstart + GL(dl_profile_map)->l_addr,
-		     HISTFRACTION * sizeof (HISTCOUNTER));
-  highpc = ROUNDUP (mapend + GL(dl_profile_map)->l_addr,
-		    HISTFRACTION * sizeof (HISTCOUNTER));
-  textsize = highpc - lowpc;
-  kcountsize = textsize / HISTFRACTION;
-  if ((HASHFRACTION & (HASHFRACTION - 1)) == 0)
-    {
-      /* If HASHFRACTION is a power of two, mcount can use shifting
-	 instead of integer division.  Precompute shift amount.
-
-	 This is a constant but the compiler cannot compile the
-	 expression away since the __ffs implementation is not known
-	 to the compiler.  Help the compiler by precomputing the
-	 usual cases.  */
-      assert (HASHFRACTION == 2);
-
-      if (sizeof (*froms) == 8)
-	log_hashfraction = 4;
-      else if (sizeof (*froms) == 16)
-	log_hashfraction = 5;
-      else
-	log_hashfraction = __ffs (HASHFRACTION * sizeof (*froms)) - 1;
-    }
-  else
-    log_hashfraction = -1;
-  tossize = textsize / HASHFRACTION;
-  fromlimit = textsize * ARCDENSITY / 100;
-  if (fromlimit < MINARCS)
-    fromlimit = MINARCS;
-  if (fromlimit > MAXARCS)
-    fromlimit = MAXARCS;
-  fromssize = fromlimit * sizeof (struct here_fromstruct);
-
+  text_start = ROUNDDOWN (mapstart + map->l_addr,
+			  HISTFRACTION * sizeof (HISTCOUNTER));
+  text_end = ROUNDUP (mapend + map->l_addr,
+		      HISTFRACTION * sizeof (HISTCOUNTER));
+  text_size = text_end - text_start;
+  countsize = text_size / HISTFRACTION;
+
+  /* Without ARCS the file ends after the (empty) list of arcs.  */
   expected_size = (sizeof (struct gmon_hdr)
-		   + 4 + sizeof (struct gmon_hist_hdr) + kcountsize
-		   + 4 + 4 + fromssize * sizeof (struct here_cg_arc_record));
+		   + 4 + sizeof (struct gmon_hist_hdr) + countsize
+		   + 4 + 4);
+  if (arcs)
+    expected_size += (profile_fromlimit (text_size)
+		      * sizeof (struct here_fromstruct)
+		      * sizeof (struct here_cg_arc_record));
 
   /* Create the gmon_hdr we expect or write.  */
   struct real_gmon_hdr
@@ -304,7 +294,7 @@ _dl_start_profile (void)
 
   hist_hdr.low_pc = (char *) mapstart;
   hist_hdr.high_pc = (char *) mapend;
-  hist_hdr.hist_size = kcountsize / sizeof (HISTCOUNTER);
+  hist_hdr.hist_size = countsize / sizeof (HISTCOUNTER);
   hist_hdr.prof_rate = __profile_frequency ();
   if (sizeof (hist_hdr.dimen) >= sizeof ("seconds"))
     {
@@ -317,13 +307,13 @@ _dl_start_profile (void)
   hist_hdr.dimen_abbrev = 's';
 
   /* First determine the output name.  We write in the directory
-     OUTPUT_DIR and the name is composed from the shared objects
-     soname (or the file name) and the ending ".profile".  */
+     OUTPUT_DIR and the name is composed from NAME and the ending
+     ".profile".  */
   filename = (char *) alloca (strlen (GLRO(dl_profile_output)) + 1
-			      + strlen (GLRO(dl_profile)) + sizeof ".profile");
+			      + strlen (name) + sizeof ".profile");
   cp = __stpcpy (filename, GLRO(dl_profile_output));
   *cp++ = '/';
-  __stpcpy (__stpcpy (cp, GLRO(dl_profile)), ".profile");
+  __stpcpy (__stpcpy (cp, name), ".profile");
 
   fd = __open (filename, O_RDWR | O_CREAT | O_NOFOLLOW, DEFFILEMODE);
   if (fd == -1)
@@ -339,7 +329,7 @@ _dl_start_profile (void)
 	__close (fd);
       _dl_error_printf (errstr, filename,
 			__strerror_r (errnum, buf, sizeof buf));
-      return;
+      return false;
     }
 
   if (__fxstat64 (_STAT_VER, fd, &st) < 0 || !S_ISREG (st.st_mode))
@@ -380,8 +370,8 @@ _dl_start_profile (void)
 	__munmap ((void *) addr, expected_size);
 
       _dl_error_printf ("%s: file is no correct profile data file for `%s'\n",
-			filename, GLRO(dl_profile));
-      return;
+			filename, name);
+      return false;
     }
 
   addr = (struct gmon_hdr *) __mmap (NULL, expected_size, PROT_READ|PROT_WRITE,
@@ -400,9 +390,8 @@ _dl_start_profile (void)
   kcount = (uint16_t *) ((char *) hist + sizeof (uint32_t)
 			 + sizeof (struct gmon_hist_hdr));
 
-  /* Compute pointer to array of the arc information.  */
-  narcsp = (uint32_t *) ((char *) kcount + kcountsize + sizeof (uint32_t));
-  data = (struct here_cg_arc_record *) ((char *) narcsp + sizeof (uint32_t));
+  /* The tag of the arc information follows the counters.  */
+  arctag = (uint32_t *) ((char *) kcount + countsize);
 
   if (st.st_size == 0)
     {
@@ -413,7 +402,7 @@ _dl_start_profile (void)
       memcpy (hist + sizeof (uint32_t), &hist_hdr,
 	      sizeof (struct gmon_hist_hdr));
 
-      narcsp[-1] = GMON_TAG_CG_ARC;
+      *arctag = GMON_TAG_CG_ARC;
     }
   else
     {
@@ -422,15 +411,75 @@ _dl_start_profile (void)
 	  || *(uint32_t *) hist != GMON_TAG_TIME_HIST
 	  || memcmp (hist + sizeof (uint32_t), &hist_hdr,
 		     sizeof (struct gmon_hist_hdr)) != 0
-	  || narcsp[-1] != GMON_TAG_CG_ARC)
+	  || *arctag != GMON_TAG_CG_ARC)
 	goto wrong_format;
     }
 
+  result->addr = addr;
+  result->size = expected_size;
+  result->lowpc = text_start;
+  result->textsize = text_size;
+  result->kcount = kcount;
+  return true;
+}
+
+
+/* Set up profiling data to profile object desribed by
+   GL(dl_profile_map).  */
+void
+internal_function
+_dl_start_profile (void)
+{
+  struct dl_profile_hist hist;
+  size_t idx;
+  size_t kcountsize;
+  size_t tossize;
+  size_t fromssize;
+  /* See profil(2) where this is described.  */
+  int s_scale;
+#define SCALE_1_TO_1	0x10000L
+
+  running = 0;
+  if (! _dl_profile_open (GL(dl_profile_map), GLRO(dl_profile), true, &hist))
+    return;
+
+  lowpc = hist.lowpc;
+  textsize = hist.textsize;
+  kcountsize = textsize / HISTFRACTION;
+  if ((HASHFRACTION & (HASHFRACTION - 1)) == 0)
+    {
+      /* If HASHFRACTION is a power of two, mcount can use shifting
+	 instead of integer division.  Precompute shift amount.
+
+	 This is a constant but the compiler cannot compile the
+	 expression away since the __ffs implementation is not known
+	 to the compiler.  Help the compiler by precomputing the
+	 usual cases.  */
+      assert (HASHFRACTION == 2);
+
+      if (sizeof (*froms) == 8)
+	log_hashfraction = 4;
+      else if (sizeof (*froms) == 16)
+	log_hashfraction = 5;
+      else
+	log_hashfraction = __ffs (HASHFRACTION * sizeof (*froms)) - 1;
+    }
+  else
+    log_hashfraction = -1;
+  tossize = textsize / HASHFRACTION;
+  fromlimit = profile_fromlimit (textsize);
+  fromssize = fromlimit * sizeof (struct here_fromstruct);
+
+  /* Compute pointer to array of the arc information.  */
+  narcsp = (uint32_t *) ((char *) hist.kcount + kcountsize
+			 + sizeof (uint32_t));
+  data = (struct here_cg_arc_record *) ((char *) narcsp + sizeof (uint32_t));
+
   /* Allocate memory for the froms data and the pointer to the tos records.  */
   tos = (uint16_t *) calloc (tossize + fromssize, 1);
   if (tos == NULL)
     {
-      __munmap ((void *) addr, expected_size);
+      __munmap (hist.addr, hist.size);
       _dl_fatal_printf ("Out of memory while initializing profiler\n");
       /* NOTREACHED */
     }
@@ -458,12 +507,12 @@ _dl_start_profile (void)
     }
 
   /* Setup counting data.  */
-  if (kcountsize < highpc - lowpc)
+  if (kcountsize < textsize)
     {
 #if 0
-      s_scale = ((double) kcountsize / (highpc - lowpc)) * SCALE_1_TO_1;
+      s_scale = ((double) kcountsize / textsize) * SCALE_1_TO_1;
 #else
-      size_t range = highpc - lowpc;
+      size_t range = textsize;
       size_t quot = range / kcountsize;
 
       if (quot >= SCALE_1_TO_1)
@@ -479,8 +528,10 @@ _dl_start_profile (void)
   else
     s_scale = SCALE_1_TO_1;
 
-  /* Start the profiler.  */
-  __profil ((void *) kcount, kcountsize, lowpc, s_scale);
+  /* Start the profiler.  If the sampling profiler is running, it
+     already updates the histogram in the file.  */
+  if (! _dl_profile_sampling)
+    __profil ((void *) hist.kcount, kcountsize, lowpc, s_scale);
 
   /* Turn on profiling.  */
   running = 1;
@@ -43,10 +43,10 @@
    we set MAP->l_tls_offset and return.
    This function intentionally does not return any value but signals error
    directly, as static TLS should be rare and code handling it should
-   not be inlined as much as possible.  */
-int
-internal_function
-_dl_try_allocate_static_tls (struct link_map *map)
+   not be inlined as much as possible.  The allocation must end at or
+   before offset LIMIT in the static TLS block.  */
+static int
+try_allocate_static_tls (struct link_map *map, size_t limit)
 {
   /* If we've already used the variable with dynamic access, or if the
      alignment requirements are too high, fail.  */
@@ -58,7 +58,9 @@ _dl_try_allocate_static_tls (struct link_map *map)
     }
 
 #if TLS_TCB_AT_TP
-  size_t freebytes = GL(dl_tls_static_size) - GL(dl_tls_static_used);
+  if (limit < GL(dl_tls_static_used))
+    goto fail;
+  size_t freebytes = limit - GL(dl_tls_static_used);
   if (freebytes < TLS_TCB_SIZE)
     goto fail;
   freebytes -= TLS_TCB_SIZE;
@@ -81,7 +83,7 @@ _dl_try_allocate_static_tls (struct link_map *map)
 		   + map->l_tls_firstbyte_offset);
   size_t used = offset + map->l_tls_blocksize;
 
-  if (used > GL(dl_tls_static_size))
+  if (used > limit)
     goto fail;
 
   map->l_tls_offset = offset;
@@ -111,6 +113,28 @@ _dl_try_allocate_static_tls (struct link_map *map)
   return 0;
 }
 
+int
+internal_function
+_dl_try_allocate_static_tls (struct link_map *map)
+{
+  return try_allocate_static_tls (map, GL(dl_tls_static_size));
+}
+
+/* The optional part of the surplus is used on a first-come basis.  The
+   TLS_STATIC_SURPLUS bytes at the end of the block stay available for
+   modules which cannot work without static TLS.  */
+int
+internal_function
+_dl_try_allocate_optional_static_tls (struct link_map *map)
+{
+  if (GL(dl_tls_static_optional) == 0
+      || GL(dl_tls_static_size) < TLS_STATIC_SURPLUS)
+    return -1;
+
+  return try_allocate_static_tls (map, (GL(dl_tls_static_size)
+					- TLS_STATIC_SURPLUS));
+}
+
 void
 internal_function __attribute_noinline__
 _dl_allocate_static_tls (struct link_map *map)
@@ -171,6 +195,12 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
   if (l->l_relocated)
     return;
 
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  hp_timing_t start_time = 0;
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    HP_TIMING_NOW (start_time);
+#endif
+
   /* If DT_BIND_NOW is set relocate all references in this object.  We
      do not do this if we are profiling, of course.  */
   // XXX Correct for auditing?
@@ -305,6 +335,15 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
      done, do it.  */
   if (l->l_relro_size != 0)
     _dl_protect_relro (l);
+
+#if defined SHARED && !defined HP_TIMING_NONAVAIL
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    {
+      hp_timing_t stop_time;
+      HP_TIMING_NOW (stop_time);
+      HP_TIMING_DIFF (l->l_stats.relocate_time, start_time, stop_time);
+    }
+#endif
 }
 
 
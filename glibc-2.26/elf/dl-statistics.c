@@ -0,0 +1,202 @@
+/* Per-object statistics for LD_DEBUG=statistics.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldsodefs.h>
+#include <string.h>
+#include <unistd.h>
+#include <_itoa.h>
+
+static const char event_names[][8] =
+  {
+    [dl_statistics_startup] = "startup",
+    [dl_statistics_init] = "init",
+    [dl_statistics_dlopen] = "dlopen"
+  };
+
+/* Large enough for the decimal representation of a 64-bit value.  */
+#define NUMBUF_SIZE 21
+
+/* Return the decimal representation of VALUE, stored in BUF.  */
+static char *
+number (char *buf, unsigned long long int value)
+{
+  buf[NUMBUF_SIZE - 1] = '\0';
+  return _itoa (value, &buf[NUMBUF_SIZE - 1], 10, 0);
+}
+
+/* Store S as a JSON string literal in BUF, which must have room for
+   6 * strlen (S) + 3 bytes, and return BUF.  */
+static char *
+json_string (char *buf, const char *s)
+{
+  char *p = buf;
+  *p++ = '"';
+  for (; *s != '\0'; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	{
+	  *p++ = '\\';
+	  *p++ = c;
+	}
+      else if (c < 0x20)
+	{
+	  p = __mempcpy (p, "\\u00", 4);
+	  *p++ = _itoa_lower_digits[c >> 4];
+	  *p++ = _itoa_lower_digits[c & 15];
+	}
+      else
+	*p++ = c;
+    }
+  *p++ = '"';
+  *p = '\0';
+  return buf;
+}
+
+static bool
+include_object (const struct dl_statistics *stats, struct link_map *l)
+{
+  if (stats->event == dl_statistics_init)
+    return l->l_stats.init_time != 0;
+  return !l->l_stats.reported;
+}
+
+static void
+print_object_text (struct link_map *l)
+{
+  char map[NUMBUF_SIZE];
+  char reloc[NUMBUF_SIZE];
+  char lookup[NUMBUF_SIZE];
+  char init[NUMBUF_SIZE];
+
+  _dl_debug_printf ("    %s [%lu]: map %s cycles, relocation %s cycles, "
+		    "%lu lookups in %s cycles, init %s cycles\n",
+		    DSO_FILENAME (l->l_name), l->l_ns,
+		    number (map, l->l_stats.map_time),
+		    number (reloc, l->l_stats.relocate_time),
+		    l->l_stats.num_lookups,
+		    number (lookup, l->l_stats.lookup_time),
+		    number (init, l->l_stats.init_time));
+}
+
+static void
+print_object_json (struct link_map *l, const char *sep)
+{
+  const char *name = DSO_FILENAME (l->l_name);
+  char namebuf[6 * strlen (name) + 3];
+  char map[NUMBUF_SIZE];
+  char reloc[NUMBUF_SIZE];
+  char lookup[NUMBUF_SIZE];
+  char init[NUMBUF_SIZE];
+
+  _dl_dprintf (GLRO(dl_debug_fd),
+	       "%s{\"name\":%s,\"namespace\":%lu,\"map_cycles\":%s,"
+	       "\"relocation_cycles\":%s,\"lookups\":%lu,"
+	       "\"lookup_cycles\":%s,\"init_cycles\":%s}",
+	       sep, json_string (namebuf, name), l->l_ns,
+	       number (map, l->l_stats.map_time),
+	       number (reloc, l->l_stats.relocate_time),
+	       l->l_stats.num_lookups,
+	       number (lookup, l->l_stats.lookup_time),
+	       number (init, l->l_stats.init_time));
+}
+
+/* Print the totals as the start of a JSON record.  */
+static void
+print_totals_json (const struct dl_statistics *stats)
+{
+  const char *file = stats->file ?: "";
+  char filebuf[6 * strlen (file) + 3];
+  char total[NUMBUF_SIZE];
+  char reloc[NUMBUF_SIZE];
+  char load[NUMBUF_SIZE];
+
+  _dl_dprintf (GLRO(dl_debug_fd),
+	       "{\"event\":\"%s\",\"pid\":%u,\"file\":%s,\"namespace\":%lu,"
+	       "\"total_cycles\":%s,\"relocation_cycles\":%s,"
+	       "\"load_cycles\":%s,\"relocations\":%lu,"
+	       "\"cache_relocations\":%lu,\"relative_relocations\":%lu,"
+	       "\"objects\":[",
+	       event_names[stats->event], (unsigned int) __getpid (),
+	       json_string (filebuf, file), stats->nsid,
+	       number (total, stats->total_time),
+	       number (reloc, stats->relocate_time),
+	       number (load, stats->load_time),
+	       stats->num_relocations, stats->num_cache_relocations,
+	       stats->num_relative_relocations);
+}
+
+/* The startup totals are printed by the caller in text mode.  */
+static void
+print_totals_text (const struct dl_statistics *stats)
+{
+  char total[NUMBUF_SIZE];
+
+  switch (stats->event)
+    {
+    case dl_statistics_startup:
+      _dl_debug_printf ("   per-object statistics:\n");
+      break;
+
+    case dl_statistics_init:
+      _dl_debug_printf ("\nruntime linker statistics for constructors:\n"
+			"   total time in constructors: %s cycles\n",
+			number (total, stats->total_time));
+      break;
+
+    case dl_statistics_dlopen:
+      _dl_debug_printf ("\nruntime linker statistics for dlopen of %s [%lu]:\n"
+			"            total time in dlopen: %s cycles\n"
+			"           number of relocations: %lu\n"
+			"number of relocations from cache: %lu\n"
+			"   per-object statistics:\n",
+			stats->file, stats->nsid,
+			number (total, stats->total_time),
+			stats->num_relocations, stats->num_cache_relocations);
+      break;
+    }
+}
+
+void
+_dl_statistics_report (const struct dl_statistics *stats)
+{
+  bool json = (GLRO(dl_debug_mask) & DL_DEBUG_JSON) != 0;
+  Lmid_t nsid = (stats->event == dl_statistics_init
+		 ? LM_ID_BASE : stats->nsid);
+
+  if (json)
+    print_totals_json (stats);
+  else
+    print_totals_text (stats);
+
+  const char *sep = "";
+  for (struct link_map *l = GL(dl_ns)[nsid]._ns_loaded; l != NULL;
+       l = l->l_next)
+    if (include_object (stats, l))
+      {
+	if (json)
+	  print_object_json (l, sep);
+	else
+	  print_object_text (l);
+	sep = ",";
+	l->l_stats.reported = 1;
+      }
+
+  if (json)
+    _dl_dprintf (GLRO(dl_debug_fd), "]}\n");
+}
@@ -0,0 +1,74 @@
+/* Per-handle cache of dlsym results.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_SYM_CACHE_H
+#define _DL_SYM_CACHE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <ldsodefs.h>
+
+/* The local scope of a dlopen handle does not change while the handle
+   is open, so the result of a dlsym call for a name is the same every
+   time.  The exception is the main program, whose local scope is the
+   global scope; lookups in it are not cached.  The results are kept in
+   an open addressing hash table with linear probing, which is filled by
+   _dl_sym while holding GL(dl_load_lock) and read by _dl_sym_cached
+   without any lock.  */
+struct dl_sym_cache_entry
+{
+  /* Copy of the symbol name, or NULL for an unused entry.  Written
+     last, with release MO.  */
+  const char *name;
+  uint32_t hash;
+  void *value;
+};
+
+struct dl_sym_cache
+{
+  /* The table this one has replaced when it became too full.  Readers
+     may still use it, so it is only freed with the link map.  */
+  struct dl_sym_cache *previous;
+  /* Number of entries, a power of two.  */
+  size_t size;
+  /* Number of entries in use, at most half of SIZE.  */
+  size_t used;
+  struct dl_sym_cache_entry entries[];
+};
+
+/* Free the dlsym cache of MAP, which is being destroyed.  */
+static inline void
+_dl_sym_cache_free (struct link_map *map)
+{
+  struct dl_sym_cache *cache = map->l_sym_cache;
+  if (cache == NULL)
+    return;
+
+  /* The names are shared with the previous tables.  */
+  for (size_t i = 0; i < cache->size; ++i)
+    free ((char *) cache->entries[i].name);
+  while (cache != NULL)
+    {
+      struct dl_sym_cache *previous = cache->previous;
+      free (cache);
+      cache = previous;
+    }
+  map->l_sym_cache = NULL;
+}
+
+#endif /* _DL_SYM_CACHE_H */
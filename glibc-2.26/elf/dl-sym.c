@@ -20,6 +20,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <string.h>
 #include <libintl.h>
 
 #include <dlfcn.h>
@@ -28,6 +29,8 @@
 #include <sysdep-cancel.h>
 #include <dl-tls.h>
 #include <dl-irel.h>
+#include <dl-sym-cache.h>
+#include <atomic.h>
 
 
 #ifdef SHARED
@@ -82,6 +85,105 @@ call_dl_lookup (void *ptr)
 }
 
 
+/* Return the cached value of NAME in the dlsym cache of MAP, or NULL.  */
+static void *
+sym_cache_lookup (struct link_map *map, const char *name, uint32_t hash)
+{
+  struct dl_sym_cache *cache = atomic_load_acquire (&map->l_sym_cache);
+  if (cache == NULL)
+    return NULL;
+
+  /* The table is never more than half full, so there is always an
+     unused entry which ends the search.  */
+  size_t mask = cache->size - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+      struct dl_sym_cache_entry *e = &cache->entries[i];
+      const char *ename = atomic_load_acquire (&e->name);
+      if (ename == NULL)
+	return NULL;
+      if (e->hash == hash && strcmp (ename, name) == 0)
+	return e->value;
+    }
+}
+
+/* Return true if the results of lookups in MAP can be cached.  This is
+   not the case for the main program of a namespace (including the
+   handle returned by dlopen (NULL)), whose local scope is the global
+   scope of the namespace and changes with dlopen and dlclose.  */
+static inline bool
+sym_cache_usable (struct link_map *map)
+{
+  return map->l_local_scope[0] != GL(dl_ns)[map->l_ns]._ns_main_searchlist;
+}
+
+/* Store NAME in the unused entry for it in CACHE, unless it is already
+   present.  Return false if the name is present.  */
+static bool
+sym_cache_insert (struct dl_sym_cache *cache, const char *name,
+		  uint32_t hash, void *value)
+{
+  size_t mask = cache->size - 1;
+  size_t i = hash & mask;
+  for (; cache->entries[i].name != NULL; i = (i + 1) & mask)
+    if (cache->entries[i].hash == hash
+	&& strcmp (cache->entries[i].name, name) == 0)
+      return false;
+
+  struct dl_sym_cache_entry *e = &cache->entries[i];
+  e->hash = hash;
+  e->value = value;
+  atomic_store_release (&e->name, name);
+  ++cache->used;
+  return true;
+}
+
+/* Add NAME with VALUE to the dlsym cache of MAP.  Called with
+   GL(dl_load_lock) held, which serializes the writers.  Failure to
+   allocate memory just leaves the name uncached.  */
+static void
+sym_cache_add (struct link_map *map, const char *name, uint32_t hash,
+	       void *value)
+{
+  struct dl_sym_cache *cache = map->l_sym_cache;
+  if (cache == NULL || 2 * (cache->used + 1) > cache->size)
+    {
+      size_t size = cache == NULL ? 16 : 2 * cache->size;
+      struct dl_sym_cache *newcache
+	= calloc (1, sizeof (*newcache)
+		     + size * sizeof (struct dl_sym_cache_entry));
+      if (newcache == NULL)
+	return;
+      newcache->previous = cache;
+      newcache->size = size;
+      if (cache != NULL)
+	for (size_t i = 0; i < cache->size; ++i)
+	  if (cache->entries[i].name != NULL)
+	    sym_cache_insert (newcache, cache->entries[i].name,
+			      cache->entries[i].hash, cache->entries[i].value);
+      /* Readers see either the old or the fully initialized new
+	 table.  */
+      atomic_store_release (&map->l_sym_cache, newcache);
+      cache = newcache;
+    }
+
+  char *copy = __strdup (name);
+  if (copy != NULL && !sym_cache_insert (cache, copy, hash, value))
+    free (copy);
+}
+
+
+void *
+internal_function
+_dl_sym_cached (void *handle, const char *name)
+{
+  if (handle == RTLD_DEFAULT || handle == RTLD_NEXT
+      || !sym_cache_usable (handle))
+    return NULL;
+  return sym_cache_lookup (handle, name, _dl_elf_hash (name));
+}
+
+
 static void *
 internal_function
 do_sym (void *handle, const char *name, void *who,
@@ -242,6 +344,18 @@ RTLD_NEXT used in code not dynamically loaded"));
 	}
 #endif
 
+      /* Cache the result of plain dlsym calls on a handle.  The value
+	 of a TLS symbol depends on the thread, and auditing and the
+	 debugging output need to see every call.  */
+      if (handle != RTLD_DEFAULT && handle != RTLD_NEXT && vers == NULL
+	  && value != NULL && sym_cache_usable (handle)
+	  && ELFW(ST_TYPE) (ref->st_info) != STT_TLS
+#ifdef SHARED
+	  && GLRO(dl_naudit) == 0
+#endif
+	  && (GLRO(dl_debug_mask) & DL_DEBUG_BINDINGS) == 0)
+	sym_cache_add (handle, name, _dl_elf_hash (name), value);
+
       return value;
     }
 
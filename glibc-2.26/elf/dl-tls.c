@@ -29,9 +29,10 @@
 #include <dl-tls.h>
 #include <ldsodefs.h>
 
-/* Amount of excess space to allocate in the static TLS area
-   to allow dynamic loading of modules defining IE-model TLS data.  */
-#define TLS_STATIC_SURPLUS	64 + DL_NNS * 100
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
 
 
 /* Out-of-memory handler.  */
@@ -140,6 +141,18 @@ _dl_determine_tlsoffset (void)
   size_t freetop = 0;
   size_t freebottom = 0;
 
+  /* The static TLS block has room for the TLS data of modules loaded
+     with dlopen which use the initial-exec model, and for the blocks
+     of other dlopen'ed modules which ld.so places there so that
+     accessing their TLS data does not need a lazy allocation.  */
+#if HAVE_TUNABLES
+  GL(dl_tls_static_optional) = TUNABLE_GET (optional_static_tls, size_t,
+					    NULL);
+#else
+  GL(dl_tls_static_optional) = 512;
+#endif
+  size_t surplus = TLS_STATIC_SURPLUS + GL(dl_tls_static_optional);
+
   /* The first element of the dtv slot info list is allocated.  */
   assert (GL(dl_tls_dtv_slotinfo_list) != NULL);
   /* There is at this point only one element in the
@@ -221,7 +234,7 @@ _dl_determine_tlsoffset (void)
     }
 
   GL(dl_tls_static_used) = offset;
-  GL(dl_tls_static_size) = (roundup (offset + TLS_STATIC_SURPLUS, max_align)
+  GL(dl_tls_static_size) = (roundup (offset + surplus, max_align)
 			    + TLS_TCB_SIZE);
 #elif TLS_DTV_AT_TP
   /* The TLS blocks start right after the TCB.  */
@@ -265,7 +278,7 @@ _dl_determine_tlsoffset (void)
     }
 
   GL(dl_tls_static_used) = offset;
-  GL(dl_tls_static_size) = roundup (offset + TLS_STATIC_SURPLUS,
+  GL(dl_tls_static_size) = roundup (offset + surplus,
 				    TLS_TCB_ALIGN);
 #else
 # error "Either TLS_TCB_AT_TP or TLS_DTV_AT_TP must be defined"
@@ -644,10 +657,16 @@ _dl_update_slotinfo (unsigned long int req_modid)
      possible that other threads at the same time dynamically load
      code and therefore add to the slotinfo list.  This is a problem
      since we must not pick up any information about incomplete work.
-     The solution to this is to ignore all dtv slots which were
-     created after the one we are currently interested.  We know that
-     dynamic loading for this module is completed and this is the last
-     load operation we know finished.  */
+     dlopen and dlclose publish the new generation counter with a
+     release store only after the slotinfo entries of that generation
+     are complete, so all entries up to the generation read below can
+     be used, and younger ones are ignored.
+
+     Updating the dtv to the newest complete generation, instead of
+     only to the generation of the requested module, means that
+     __tls_get_addr takes this slow path once per dlopen or dlclose
+     and thread, and not on every access to a module which was loaded
+     before the last one.  */
   unsigned long int idx = req_modid;
   struct dtv_slotinfo_list *listp = GL(dl_tls_dtv_slotinfo_list);
 
@@ -657,13 +676,17 @@ _dl_update_slotinfo (unsigned long int req_modid)
       listp = listp->next;
     }
 
-  if (dtv[0].counter < listp->slotinfo[idx].gen)
+  size_t new_gen = atomic_load_acquire (&GL(dl_tls_generation));
+  /* The requested module has been loaded completely, so this is only
+     a safeguard.  */
+  if (new_gen < listp->slotinfo[idx].gen)
+    new_gen = listp->slotinfo[idx].gen;
+
+  if (dtv[0].counter < new_gen)
     {
-      /* The generation counter for the slot is higher than what the
-	 current dtv implements.  We have to update the whole dtv but
-	 only those entries with a generation counter <= the one for
-	 the entry we need.  */
-      size_t new_gen = listp->slotinfo[idx].gen;
+      /* The generation counter is higher than what the current dtv
+	 implements.  We have to update the whole dtv but only those
+	 entries with a generation counter <= the new one.  */
       size_t total = 0;
 
       /* We have to look through the entire dtv slotinfo list.  */
@@ -685,27 +708,19 @@ _dl_update_slotinfo (unsigned long int req_modid)
 	      if (gen <= dtv[0].counter)
 		continue;
 
-	      /* If there is no map this means the entry is empty.  */
+	      /* The map is not dereferenced here: a module which this
+		 thread has not accessed can be unloaded concurrently.  */
+	      size_t modid = total + cnt;
 	      struct link_map *map = listp->slotinfo[cnt].map;
-	      if (map == NULL)
-		{
-		  if (dtv[-1].counter >= total + cnt)
-		    {
-		      /* If this modid was used at some point the memory
-			 might still be allocated.  */
-		      free (dtv[total + cnt].pointer.to_free);
-		      dtv[total + cnt].pointer.val = TLS_DTV_UNALLOCATED;
-		      dtv[total + cnt].pointer.to_free = NULL;
-		    }
-
-		  continue;
-		}
 
 	      /* Check whether the current dtv array is large enough.  */
-	      size_t modid = map->l_tls_modid;
-	      assert (total + cnt == modid);
 	      if (dtv[-1].counter < modid)
 		{
+		  /* If there is no map this means the entry is empty,
+		     and there is nothing allocated for it.  */
+		  if (map == NULL)
+		    continue;
+
 		  /* Resize the dtv.  */
 		  dtv = _dl_resize_dtv (dtv);
 
@@ -717,7 +732,8 @@ _dl_update_slotinfo (unsigned long int req_modid)
 		}
 
 	      /* If there is currently memory allocate for this
-		 dtv entry free it.  */
+		 dtv entry free it.  This is also done if the module
+		 has been unloaded.  */
 	      /* XXX Ideally we will at some point create a memory
 		 pool.  */
 	      free (dtv[modid].pointer.to_free);
@@ -190,12 +190,57 @@ elf_machine_lazy_rel (struct link_map *map,
 #  define ELF_DYNAMIC_DO_RELA(map, lazy, skip_ifunc) /* Nothing to do.  */
 # endif
 
+/* The dynamic linker applies its own DT_RELR relocations while
+   bootstrapping; they must not be applied again when it is relocated a
+   second time.  There is no such link map in static programs.  */
+# if defined RTLD_BOOTSTRAP || !defined SHARED
+#  define _ELF_DYNAMIC_RELR_SKIP(map) 0
+# else
+#  define _ELF_DYNAMIC_RELR_SKIP(map) ((map) == &GL(dl_rtld_map))
+# endif
+
+/* Apply the DT_RELR relative relocations of MAP.  Each even entry is
+   the address of a word to relocate, and each odd entry is a bitmap
+   which selects some of the following 8 * sizeof (ElfW(Relr)) - 1
+   words.  Like the relative relocations in DT_REL and DT_RELA, they
+   are skipped if the object is loaded at its link-time address.  */
+# define ELF_DYNAMIC_DO_RELR(map) \
+  do {									      \
+    ElfW(Addr) l_addr = (map)->l_addr;					      \
+    if ((map)->l_info[DT_RELR] == NULL || l_addr == 0			      \
+	|| _ELF_DYNAMIC_RELR_SKIP (map))					      \
+      break;								      \
+    const ElfW(Relr) *r							      \
+      = (const ElfW(Relr) *) D_PTR ((map), l_info[DT_RELR]);		      \
+    const ElfW(Relr) *end						      \
+      = (const ElfW(Relr) *) ((const char *) r				      \
+			      + (map)->l_info[DT_RELRSZ]->d_un.d_val);	      \
+    ElfW(Addr) *where = NULL;						      \
+    for (; r < end; ++r)						      \
+      {									      \
+	ElfW(Relr) entry = *r;						      \
+	if ((entry & 1) == 0)						      \
+	  {								      \
+	    where = (ElfW(Addr) *) (l_addr + entry);			      \
+	    *where++ += l_addr;						      \
+	  }								      \
+	else								      \
+	  {								      \
+	    for (ElfW(Addr) *p = where; (entry >>= 1) != 0; ++p)	      \
+	      if ((entry & 1) != 0)					      \
+		*p += l_addr;						      \
+	    where += 8 * sizeof (ElfW(Relr)) - 1;			      \
+	  }								      \
+      }									      \
+  } while (0)
+
 /* This can't just be an inline function because GCC is too dumb
    to inline functions containing inlines themselves.  */
 # define ELF_DYNAMIC_RELOCATE(map, lazy, consider_profile, skip_ifunc) \
   do {									      \
     int edr_lazy = elf_machine_runtime_setup ((map), (lazy),		      \
 					      (consider_profile));	      \
+    ELF_DYNAMIC_DO_RELR (map);						      \
     ELF_DYNAMIC_DO_REL ((map), edr_lazy, skip_ifunc);			      \
     ELF_DYNAMIC_DO_RELA ((map), edr_lazy, skip_ifunc);			      \
   } while (0)
@@ -25,6 +25,7 @@
 #include <inttypes.h>
 #include <libintl.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdio_ext.h>
@@ -34,10 +35,12 @@
 #include <stdint.h>
 #include <sys/fcntl.h>
 #include <sys/mman.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <glob.h>
 #include <libgen.h>
+#include <atomic.h>
 
 #include <ldconfig.h>
 #include <dl-cache.h>
@@ -116,6 +119,12 @@ static int opt_manual_link;
 /* Should we ignore an old auxiliary cache file?  */
 static int opt_ignore_aux_cache;
 
+/* Number of libraries to read in parallel.  */
+static unsigned int opt_jobs;
+
+/* Upper limit for opt_jobs.  */
+#define MAX_JOBS 64
+
 /* Cache file to use.  */
 static char *cache_file;
 
@@ -150,6 +159,7 @@ static const struct argp_option options[] =
   { NULL, 'l', NULL, 0, N_("Manually link individual libraries."), 0},
   { "format", 'c', N_("FORMAT"), 0, N_("Format to use: new, old or compat (default)"), 0},
   { "ignore-aux-cache", 'i', NULL, 0, N_("Ignore auxiliary cache file"), 0},
+  { "jobs", 'j', N_("JOBS"), 0, N_("Read up to JOBS libraries in parallel"), 0},
   { NULL, 0, NULL, 0, NULL, 0 }
 };
 
@@ -259,6 +269,15 @@ parse_opt (int key, char *arg, struct argp_state *state)
     case 'i':
       opt_ignore_aux_cache = 1;
       break;
+    case 'j':
+      {
+	char *endp;
+	unsigned long int jobs = strtoul (arg, &endp, 10);
+	if (*arg == '\0' || *endp != '\0' || jobs == 0 || jobs > MAX_JOBS)
+	  argp_error (state, _("invalid number of jobs: %s"), arg);
+	opt_jobs = jobs;
+      }
+      break;
     case 'l':
       opt_manual_link = 1;
       break;
@@ -665,6 +684,148 @@ struct dlib_entry
 };
 
 
+/* A file in a directory searched by search_dir which may be a
+   library.  */
+struct dlib_candidate
+{
+  char *file_name;		/* Name used in messages.  */
+  char *real_file_name;		/* Name within the chroot.  */
+  char *real_name;		/* Name to open.  */
+  char *lib;			/* Directory entry.  */
+  int is_link;
+  enum
+    {
+      candidate_cached,		/* Found in the auxiliary cache.  */
+      candidate_pending,	/* Needs to be read.  */
+      candidate_read,		/* Read successfully.  */
+      candidate_failed		/* Not a library, or unreadable.  */
+    } state;
+  /* For a pending file, another pending file which is the same file
+     and is only read once.  */
+  struct dlib_candidate *same;
+  struct stat64 stat_buf;
+  int flag;
+  unsigned int osversion;
+  char *soname;
+};
+
+/* The files to read by read_files, and the index of the next one.  */
+struct read_files_state
+{
+  struct dlib_candidate **files;
+  size_t count;
+  size_t next;
+};
+
+static void *
+read_files_thread (void *closure)
+{
+  struct read_files_state *state = closure;
+
+  while (true)
+    {
+      size_t i = atomic_fetch_add_relaxed (&state->next, 1);
+      if (i >= state->count)
+	break;
+
+      struct dlib_candidate *c = state->files[i];
+      if (process_file (c->real_name, c->file_name, c->lib, &c->flag,
+			&c->osversion, &c->soname, c->is_link, &c->stat_buf))
+	c->state = candidate_failed;
+      else
+	c->state = candidate_read;
+    }
+
+  return NULL;
+}
+
+/* Read the COUNT libraries in FILES using up to OPT_JOBS threads.  On
+   network file systems most of the time is spent waiting for the
+   server, so this helps even if there are fewer processors.  */
+static void
+read_files (struct dlib_candidate **files, size_t count)
+{
+  if (count == 0)
+    return;
+
+  struct read_files_state state = { files, count, 0 };
+
+  /* This thread reads files too.  */
+  size_t nthreads = MIN (opt_jobs, count);
+  pthread_t threads[nthreads];
+  size_t started = 0;
+  while (started + 1 < nthreads
+	 && pthread_create (&threads[started], NULL, read_files_thread,
+			    &state) == 0)
+    ++started;
+
+  read_files_thread (&state);
+
+  for (size_t i = 0; i < started; ++i)
+    pthread_join (threads[i], NULL);
+}
+
+/* Sort pending files by identity.  */
+static int
+compare_candidates (const void *p1, const void *p2)
+{
+  const struct dlib_candidate *c1 = *(const struct dlib_candidate **) p1;
+  const struct dlib_candidate *c2 = *(const struct dlib_candidate **) p2;
+
+  if (c1->stat_buf.st_dev != c2->stat_buf.st_dev)
+    return c1->stat_buf.st_dev < c2->stat_buf.st_dev ? -1 : 1;
+  if (c1->stat_buf.st_ino != c2->stat_buf.st_ino)
+    return c1->stat_buf.st_ino < c2->stat_buf.st_ino ? -1 : 1;
+  /* Keep the directory order otherwise.  */
+  return c1 < c2 ? -1 : c1 > c2;
+}
+
+/* Read all files in CANDIDATES which were not found in the auxiliary
+   cache.  A library and the symbolic links to it are only read once.  */
+static void
+read_candidates (struct dlib_candidate *candidates, size_t count)
+{
+  struct dlib_candidate **pending
+    = xmalloc (count * sizeof (struct dlib_candidate *));
+  size_t npending = 0;
+  for (size_t i = 0; i < count; ++i)
+    if (candidates[i].state == candidate_pending)
+      pending[npending++] = &candidates[i];
+
+  qsort (pending, npending, sizeof (pending[0]), compare_candidates);
+
+  size_t nunique = 0;
+  for (size_t i = 0; i < npending; ++i)
+    if (nunique > 0
+	&& pending[nunique - 1]->stat_buf.st_dev == pending[i]->stat_buf.st_dev
+	&& pending[nunique - 1]->stat_buf.st_ino == pending[i]->stat_buf.st_ino)
+      pending[i]->same = pending[nunique - 1];
+    else
+      pending[nunique++] = pending[i];
+
+  read_files (pending, nunique);
+  free (pending);
+
+  /* Fill in the duplicates.  Their state is not set to candidate_read,
+     so they are not entered into the auxiliary cache twice.  */
+  for (size_t i = 0; i < count; ++i)
+    {
+      struct dlib_candidate *c = &candidates[i];
+      if (c->same == NULL)
+	continue;
+
+      if (c->same->state == candidate_failed)
+	c->state = candidate_failed;
+      else
+	{
+	  c->state = candidate_cached;
+	  c->flag = c->same->flag;
+	  c->osversion = c->same->osversion;
+	  c->soname = c->same->soname ? xstrdup (c->same->soname) : NULL;
+	}
+    }
+}
+
 static void
 search_dir (const struct dir_entry *entry)
 {
@@ -705,11 +866,14 @@ search_dir (const struct dir_entry *entry)
       return;
     }
 
+  /* First collect the files which may be libraries, and look them up
+     in the auxiliary cache.  */
   struct dirent64 *direntry;
-  struct dlib_entry *dlibs = NULL;
+  struct dlib_candidate *candidates = NULL;
+  size_t ncandidates = 0;
+  size_t candidates_size = 0;
   while ((direntry = readdir64 (dir)) != NULL)
     {
-      int flag;
 #ifdef _DIRENT_HAVE_D_TYPE
       /* We only look at links and regular files.  */
       if (direntry->d_type != DT_UNKNOWN
@@ -811,7 +975,8 @@ search_dir (const struct dir_entry *entry)
 	  lstat_buf.st_dev = stat_buf.st_dev;
 	  lstat_buf.st_ino = stat_buf.st_ino;
 	  lstat_buf.st_size = stat_buf.st_size;
-	  lstat_buf.st_ctime = stat_buf.st_ctime;
+	  lstat_buf.st_ctim = stat_buf.st_ctim;
+	  lstat_buf.st_mtim = stat_buf.st_mtim;
 	}
       else
 	is_dir = S_ISDIR (lstat_buf.st_mode);
@@ -858,7 +1023,7 @@ search_dir (const struct dir_entry *entry)
 	    }
 	}
       else
-	real_name = real_file_name;
+	real_name = NULL;
 
 #ifdef _DIRENT_HAVE_D_TYPE
       /* Call lstat64 if not done yet.  */
@@ -871,25 +1036,53 @@ search_dir (const struct dir_entry *entry)
 	}
 #endif
 
-      /* First search whether the auxiliary cache contains this
-	 library already and it's not changed.  */
-      char *soname;
-      unsigned int osversion;
-      if (!search_aux_cache (&lstat_buf, &flag, &osversion, &soname))
+      if (ncandidates == candidates_size)
 	{
-	  if (process_file (real_name, file_name, direntry->d_name, &flag,
-			    &osversion, &soname, is_link, &lstat_buf))
-	    {
-	      if (real_name != real_file_name)
-		free (real_name);
-	      continue;
-	    }
-	  else if (opt_build_cache)
-	    add_to_aux_cache (&lstat_buf, flag, osversion, soname);
+	  candidates_size = candidates_size ? 2 * candidates_size : 64;
+	  candidates = xrealloc (candidates,
+				 candidates_size * sizeof (candidates[0]));
 	}
+      struct dlib_candidate *c = &candidates[ncandidates++];
+      c->file_name = xstrdup (file_name);
+      c->real_file_name = opt_chroot ? xstrdup (real_file_name) : c->file_name;
+      c->real_name = real_name ?: c->real_file_name;
+      c->lib = xstrdup (direntry->d_name);
+      c->is_link = is_link;
+      c->same = NULL;
+      c->stat_buf = lstat_buf;
+
+      /* First search whether the auxiliary cache contains this
+	 library already and it's not changed.  */
+      if (search_aux_cache (&c->stat_buf, &c->flag, &c->osversion,
+			    &c->soname))
+	c->state = candidate_cached;
+      else
+	c->state = candidate_pending;
+    }
+
+  closedir (dir);
+
+  /* Read the libraries which have changed, in parallel.  */
+  read_candidates (candidates, ncandidates);
+
+  /* Now process the files in directory order.  */
+  struct dlib_entry *dlibs = NULL;
+  for (size_t i = 0; i < ncandidates; ++i)
+    {
+      struct dlib_candidate *c = &candidates[i];
+      if (c->state == candidate_failed)
+	continue;
+      if (c->state == candidate_read && opt_build_cache)
+	add_to_aux_cache (&c->stat_buf, c->flag, c->osversion, c->soname);
+
+      int flag = c->flag;
+      unsigned int osversion = c->osversion;
+      char *soname = c->soname;
+      int is_link = c->is_link;
+      size_t len;
 
       if (soname == NULL)
-	soname = implicit_soname (direntry->d_name, flag);
+	soname = implicit_soname (c->lib, flag);
 
       /* A link may just point to itself.  */
       if (is_link)
@@ -918,7 +1111,7 @@ search_dir (const struct dir_entry *entry)
 	     (typically by the removal of a development pacakge not required
 	     for the runtime) it will break the libfoo.so.1.2 symlink and the
 	     application will fail to start.  */
-	  const char *real_base_name = basename (real_file_name);
+	  const char *real_base_name = basename (c->real_file_name);
 
 	  if (strcmp (real_base_name, soname) != 0)
 	    {
@@ -930,13 +1123,10 @@ search_dir (const struct dir_entry *entry)
 	    }
 	}
 
-      if (real_name != real_file_name)
-	free (real_name);
-
       if (is_link)
 	{
 	  free (soname);
-	  soname = xstrdup (direntry->d_name);
+	  soname = xstrdup (c->lib);
 	}
 
       if (flag == FLAG_ELF
@@ -949,13 +1139,16 @@ search_dir (const struct dir_entry *entry)
 	{
 	  if (flag == FLAG_ELF_LIBC5 && entry->flag != FLAG_ELF_LIBC5
 	      && entry->flag != FLAG_ANY)
-	    error (0, 0, _("libc5 library %s in wrong directory"), file_name);
+	    error (0, 0, _("libc5 library %s in wrong directory"),
+		   c->file_name);
 	  if (flag == FLAG_ELF_LIBC6 && entry->flag != FLAG_ELF_LIBC6
 	      && entry->flag != FLAG_ANY)
-	    error (0, 0, _("libc6 library %s in wrong directory"), file_name);
+	    error (0, 0, _("libc6 library %s in wrong directory"),
+		   c->file_name);
 	  if (flag == FLAG_LIBC4 && entry->flag != FLAG_LIBC4
 	      && entry->flag != FLAG_ANY)
-	    error (0, 0, _("libc4 library %s in wrong directory"), file_name);
+	    error (0, 0, _("libc4 library %s in wrong directory"),
+		   c->file_name);
 	}
 
       /* Add library to list.  */
@@ -969,7 +1162,7 @@ search_dir (const struct dir_entry *entry)
 		 is newer.  */
 	      if ((!is_link && dlib_ptr->is_link)
 		  || (is_link == dlib_ptr->is_link
-		      && _dl_cache_libcmp (dlib_ptr->name, direntry->d_name) < 0))
+		      && _dl_cache_libcmp (dlib_ptr->name, c->lib) < 0))
 		{
 		  /* It's newer - add it.  */
 		  /* Flag should be the same - sanity check.  */
@@ -984,11 +1177,10 @@ search_dir (const struct dir_entry *entry)
 			dlib_ptr->flag = flag;
 		      else
 			error (0, 0, _("libraries %s and %s in directory %s have same soname but different type."),
-			       dlib_ptr->name, direntry->d_name,
-			       entry->path);
+			       dlib_ptr->name, c->lib, entry->path);
 		    }
 		  free (dlib_ptr->name);
-		  dlib_ptr->name = xstrdup (direntry->d_name);
+		  dlib_ptr->name = xstrdup (c->lib);
 		  dlib_ptr->is_link = is_link;
 		  dlib_ptr->osversion = osversion;
 		}
@@ -1002,7 +1194,7 @@ search_dir (const struct dir_entry *entry)
       if (dlib_ptr == NULL)
 	{
 	  dlib_ptr = (struct dlib_entry *)xmalloc (sizeof (struct dlib_entry));
-	  dlib_ptr->name = xstrdup (direntry->d_name);
+	  dlib_ptr->name = xstrdup (c->lib);
 	  dlib_ptr->soname = soname;
 	  dlib_ptr->flag = flag;
 	  dlib_ptr->is_link = is_link;
@@ -1013,8 +1205,6 @@ search_dir (const struct dir_entry *entry)
 	}
     }
 
-  closedir (dir);
-
   /* Now dlibs contains a list of all libs - add those to the cache
      and created all symbolic links.  */
   struct dlib_entry *dlib_ptr;
@@ -1039,6 +1229,18 @@ search_dir (const struct dir_entry *entry)
       free (dlib_ptr);
     }
 
+  for (size_t i = 0; i < ncandidates; ++i)
+    {
+      struct dlib_candidate *c = &candidates[i];
+      if (c->real_name != c->real_file_name)
+	free (c->real_name);
+      if (c->real_file_name != c->file_name)
+	free (c->real_file_name);
+      free (c->file_name);
+      free (c->lib);
+    }
+  free (candidates);
+
   if (opt_chroot && dir_name)
     free (dir_name);
 }
@@ -1396,6 +1598,12 @@ main (int argc, char **argv)
 	add_system_dir (LIBDIR);
     }
 
+  if (opt_jobs == 0)
+    {
+      long int ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+      opt_jobs = ncpus > 0 ? MIN (ncpus, MAX_JOBS) : 1;
+    }
+
   const char *aux_cache_file = _PATH_LDCONFIG_AUX_CACHE;
   if (opt_chroot)
     aux_cache_file = chroot_canon (opt_chroot, aux_cache_file);
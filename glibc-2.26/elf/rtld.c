@@ -41,6 +41,9 @@
 #include <tls.h>
 #include <stap-probe.h>
 #include <stackinfo.h>
+#include <rseq-internal.h>
+#include <dl-find_object.h>
+#include <dl-prefault.h>
 
 #include <assert.h>
 
@@ -281,6 +284,7 @@ struct rtld_global_ro _rtld_global_ro attribute_relro =
     ._dl_check_caller = _dl_check_caller,
     ._dl_open = _dl_open,
     ._dl_close = _dl_close,
+    ._dl_close_multiple = _dl_close_multiple,
     ._dl_tls_get_addr_soft = _dl_tls_get_addr_soft,
 #ifdef HAVE_DL_DISCOVER_OSVERSION
     ._dl_discover_osversion = _dl_discover_osversion
@@ -740,6 +744,7 @@ cannot allocate TLS data structures for initial thread");
   if (__glibc_unlikely (lossage != NULL))
     _dl_fatal_printf ("cannot set up thread-local storage: %s\n", lossage);
   tls_init_tp_called = true;
+  _dl_rseq_init ();
 
   return tcbp;
 }
@@ -1251,6 +1256,22 @@ of this helper program; chances are you did not intend to run this program.\n\
     main_map->l_map_end = ~0;
   if (! main_map->l_text_end)
     main_map->l_text_end = ~0;
+
+  /* The kernel has mapped the main program, so its segments are
+     prefaulted here instead of in _dl_map_segments.  */
+  if (! rtld_is_main)
+    {
+      int prefault = _dl_prefault_mode (rtld_progname);
+      if (__glibc_unlikely (prefault != 0))
+	for (ph = phdr; ph < &phdr[phnum]; ++ph)
+	  if (ph->p_type == PT_LOAD)
+	    _dl_prefault_segment (main_map->l_addr + ph->p_vaddr,
+				  main_map->l_addr + ph->p_vaddr
+				  + ph->p_filesz,
+				  (((ph->p_flags & PF_R) ? PROT_READ : 0)
+				   | ((ph->p_flags & PF_W) ? PROT_WRITE : 0)),
+				  prefault);
+    }
   if (! GL(dl_rtld_map).l_libname && GL(dl_rtld_map).l_name)
     {
       /* We were invoked directly, so the program might not have a
@@ -2032,6 +2053,10 @@ ERROR: ld.so: object '%s' cannot be loaded as audit interface: %s; ignored.\n",
       _exit (0);
     }
 
+  /* Start the sampling profiler before relocation, so that the time
+     spent relocating the objects is included.  */
+  _dl_profile_sample_start ();
+
   if (main_map->l_info[ADDRIDX (DT_GNU_LIBLIST)]
       && ! __builtin_expect (GLRO(dl_profile) != NULL, 0)
       && ! __builtin_expect (GLRO(dl_dynamic_weak), 0))
@@ -2163,6 +2188,13 @@ ERROR: ld.so: object '%s' cannot be loaded as audit interface: %s; ignored.\n",
       GLRO(dl_lazy) |= consider_profiling;
 
       HP_TIMING_NOW (start);
+      /* Most references from the different objects are to the same
+	 symbols in the global scope.  */
+      _dl_lookup_memo_start (main_map);
+      /* Objects relocated on helper threads are skipped by
+	 _dl_relocate_object in the loop below.  */
+      if (!consider_profiling)
+	_dl_relocate_parallel (main_map, GLRO(dl_lazy) ? RTLD_LAZY : 0);
       unsigned i = main_map->l_searchlist.r_nlist;
       while (i-- > 0)
 	{
@@ -2189,6 +2221,9 @@ ERROR: ld.so: object '%s' cannot be loaded as audit interface: %s; ignored.\n",
 	  if (l->l_tls_blocksize != 0 && tls_init_tp_called)
 	    _dl_add_to_slotinfo (l);
 	}
+      /* Lazy binding happens after startup, possibly with objects
+	 added by dlopen.  */
+      _dl_lookup_memo_end ();
       HP_TIMING_NOW (stop);
 
       HP_TIMING_DIFF (relocate_time, start, stop);
@@ -2220,6 +2255,7 @@ ERROR: ld.so: object '%s' cannot be loaded as audit interface: %s; ignored.\n",
       if (__glibc_unlikely (lossage != NULL))
 	_dl_fatal_printf ("cannot set up thread-local storage: %s\n",
 			  lossage);
+      _dl_rseq_init ();
     }
 
   /* Make sure no new search directories have been added.  */
@@ -2249,6 +2285,10 @@ ERROR: ld.so: object '%s' cannot be loaded as audit interface: %s; ignored.\n",
       HP_TIMING_ACCUM_NT (relocate_time, add);
     }
 
+  /* Set up the index used by _dl_find_object now that all initially
+     loaded objects are in place.  */
+  _dl_find_object_init ();
+
   /* Do any necessary cleanups for the startup OS interface code.
      We do these now so that no calls are made after rtld re-relocation
      which might be resolved to different functions than we expect.
@@ -2352,6 +2392,8 @@ process_dl_debug (const char *dl_debug)
 	| DL_DEBUG_SCOPES },
       { LEN_AND_STR ("statistics"), "display relocation statistics",
 	DL_DEBUG_STATISTICS },
+      { LEN_AND_STR ("json"), "display statistics in JSON format",
+	DL_DEBUG_STATISTICS | DL_DEBUG_JSON },
       { LEN_AND_STR ("unused"), "determined unused DSOs",
 	DL_DEBUG_UNUSED },
       { LEN_AND_STR ("help"), "display this help message and exit",
@@ -2684,13 +2726,16 @@ static void
 __attribute ((noinline))
 print_statistics (hp_timing_t *rtld_total_timep)
 {
+  /* In JSON mode, the totals are part of the startup report.  */
+  bool json = (GLRO(dl_debug_mask) & DL_DEBUG_JSON) != 0;
+
 #ifndef HP_TIMING_NONAVAIL
   char buf[200];
   char *cp;
   char *wp;
 
   /* Total time rtld used.  */
-  if (HP_SMALL_TIMING_AVAIL)
+  if (HP_SMALL_TIMING_AVAIL && !json)
     {
       HP_TIMING_PRINT (buf, sizeof (buf), *rtld_total_timep);
       _dl_debug_printf ("\nruntime linker statistics:\n"
@@ -2749,16 +2794,17 @@ print_statistics (hp_timing_t *rtld_total_timep)
 	}
     }
 
-  _dl_debug_printf ("                 number of relocations: %lu\n"
-		    "      number of relocations from cache: %lu\n"
-		    "        number of relative relocations: %lu\n",
-		    GL(dl_num_relocations),
-		    GL(dl_num_cache_relocations),
-		    num_relative_relocations);
+  if (!json)
+    _dl_debug_printf ("                 number of relocations: %lu\n"
+		      "      number of relocations from cache: %lu\n"
+		      "        number of relative relocations: %lu\n",
+		      GL(dl_num_relocations),
+		      GL(dl_num_cache_relocations),
+		      num_relative_relocations);
 
 #ifndef HP_TIMING_NONAVAIL
   /* Time spend while loading the object and the dependencies.  */
-  if (HP_SMALL_TIMING_AVAIL)
+  if (HP_SMALL_TIMING_AVAIL && !json)
     {
       char pbuf[30];
       HP_TIMING_PRINT (buf, sizeof (buf), load_time);
@@ -2781,4 +2827,23 @@ print_statistics (hp_timing_t *rtld_total_timep)
 				buf, pbuf);
     }
 #endif
+
+  /* Print the statistics for the individual objects.  */
+  struct dl_statistics stats =
+    {
+      .event = dl_statistics_startup,
+      .nsid = LM_ID_BASE,
+      .num_relocations = GL(dl_num_relocations),
+      .num_cache_relocations = GL(dl_num_cache_relocations),
+      .num_relative_relocations = num_relative_relocations
+    };
+#ifndef HP_TIMING_NONAVAIL
+  if (HP_SMALL_TIMING_AVAIL)
+    {
+      stats.total_time = *rtld_total_timep;
+      stats.relocate_time = relocate_time;
+      stats.load_time = load_time;
+    }
+#endif
+  _dl_statistics_report (&stats);
 }
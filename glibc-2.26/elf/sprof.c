@@ -178,6 +178,7 @@ struct shobj
   uintptr_t highpc;
   unsigned long int kcountsize;
   size_t expected_size;		/* Expected size of profiling file.  */
+  size_t expected_hist_size;	/* Expected size without arcs.  */
   size_t tossize;
   size_t fromssize;
   size_t fromlimit;
@@ -488,10 +489,11 @@ load_shobj (const char *name)
     result->fromlimit = MAXARCS;
   result->fromssize = result->fromlimit * sizeof (struct here_fromstruct);
 
-  result->expected_size = (sizeof (struct gmon_hdr)
-			   + 4 + sizeof (struct gmon_hist_hdr)
-			   + result->kcountsize
-			   + 4 + 4
+  result->expected_hist_size = (sizeof (struct gmon_hdr)
+				+ 4 + sizeof (struct gmon_hist_hdr)
+				+ result->kcountsize
+				+ 4 + 4);
+  result->expected_size = (result->expected_hist_size
 			   + (result->fromssize
 			      * sizeof (struct here_cg_arc_record)));
 
@@ -791,7 +793,10 @@ load_profdata (const char *name, struct shobj *shobj)
       return NULL;
     }
 
-  if ((size_t) st.st_size != shobj->expected_size)
+  /* The sampling profiler of the dynamic linker writes files which
+     only contain the histogram, without room for the call graph.  */
+  if ((size_t) st.st_size != shobj->expected_size
+      && (size_t) st.st_size != shobj->expected_hist_size)
     {
       error (0, 0,
 	     _("profiling data file `%s' does not match shared object `%s'"),
@@ -841,7 +846,10 @@ load_profdata (const char *name, struct shobj *shobj)
   /* Compute pointer to array of the arc information.  */
   narcsp = (uint32_t *) ((char *) result->kcount + shobj->kcountsize
 			 + sizeof (uint32_t));
-  result->narcs = *narcsp;
+  if ((size_t) st.st_size == shobj->expected_size)
+    result->narcs = *narcsp;
+  else
+    result->narcs = 0;
   result->data = (struct here_cg_arc_record *) ((char *) narcsp
 						+ sizeof (uint32_t));
 
@@ -935,7 +943,7 @@ load_profdata (const char *name, struct shobj *shobj)
   data = result->data;
   froms = result->froms;
   tos = result->tos;
-  for (idx = 0; idx < MIN (*narcsp, fromlimit); ++idx)
+  for (idx = 0; idx < MIN (result->narcs, fromlimit); ++idx)
     {
       size_t to_index;
       size_t newfromidx;
@@ -24,8 +24,10 @@
 #include <stdlib.h>
 #include <unwind.h>
 
-/* These programs do not use thread cancellation, so _Unwind_Resume
-   and the personality routine are never actually called.  */
+/* These programs do not use thread cancellation, so _Unwind_Resume,
+   _Unwind_ForcedUnwind, _Unwind_GetCFA and the personality routine are
+   never actually called.  The last two are referenced by libpthread,
+   which ldconfig uses to read libraries in parallel.  */
 
 void
 _Unwind_Resume (struct _Unwind_Exception *exc __attribute__ ((unused)))
@@ -44,3 +46,17 @@ __gcc_personality_v0 (int version __attribute__ ((unused)),
 {
   abort ();
 }
+
+_Unwind_Reason_Code
+_Unwind_ForcedUnwind (struct _Unwind_Exception *exc __attribute__ ((unused)),
+		      _Unwind_Stop_Fn stop __attribute__ ((unused)),
+		      void *stop_argument __attribute__ ((unused)))
+{
+  abort ();
+}
+
+_Unwind_Word
+_Unwind_GetCFA (struct _Unwind_Context *context __attribute__ ((unused)))
+{
+  abort ();
+}
@@ -0,0 +1,94 @@
+/* Test the JSON output of LD_DEBUG=json.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xstdio.h>
+
+static int
+do_test (void)
+{
+  const char *output = getenv ("LD_DEBUG_OUTPUT");
+  if (output == NULL)
+    FAIL_UNSUPPORTED ("LD_DEBUG_OUTPUT not set");
+
+  /* RTLD_NOLOAD of an object which is not loaded yet does not map it,
+     so there are no statistics to record for it.  */
+  void *handle = dlopen (LIBRT_SO, RTLD_NOW | RTLD_NOLOAD);
+  if (handle != NULL)
+    dlclose (handle);
+
+  handle = dlopen (LIBM_SO, RTLD_NOW);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+
+  /* The dynamic linker appends the process ID to the file name.  */
+  char *path = xasprintf ("%s.%d", output, (int) getpid ());
+  FILE *fp = xfopen (path, "r");
+
+  bool startup = false;
+  bool init = false;
+  bool dlopen_libm = false;
+  char *line = NULL;
+  size_t linelen = 0;
+  while (getline (&line, &linelen, fp) > 0)
+    {
+      /* Every line is a complete record.  */
+      TEST_VERIFY (line[0] == '{');
+      TEST_VERIFY (strstr (line, "]}\n") != NULL);
+
+      if (strncmp (line, "{\"event\":\"startup\"", 18) == 0)
+	{
+	  startup = true;
+	  TEST_VERIFY (strstr (line, "\"relocation_cycles\":") != NULL);
+	  TEST_VERIFY (strstr (line, "\"lookups\":") != NULL);
+	  TEST_VERIFY (strstr (line, "\"name\":\"" LIBC_SO) != NULL
+		       || strstr (line, "/" LIBC_SO "\"") != NULL);
+	}
+      else if (strncmp (line, "{\"event\":\"init\"", 15) == 0)
+	init = true;
+      else if (strncmp (line, "{\"event\":\"dlopen\"", 17) == 0
+	       && strstr (line, "\"file\":\"" LIBM_SO "\"") != NULL)
+	{
+	  dlopen_libm = true;
+	  TEST_VERIFY (strstr (line, "/" LIBM_SO "\"") != NULL
+		       || strstr (line, "\"name\":\"" LIBM_SO "\"") != NULL);
+	  /* libc.so.6 has been reported at startup already.  */
+	  TEST_VERIFY (strstr (line, LIBC_SO) == NULL);
+	}
+    }
+
+  TEST_VERIFY (startup);
+  TEST_VERIFY (init);
+  TEST_VERIFY (dlopen_libm);
+
+  free (line);
+  xfclose (fp);
+  free (path);
+  dlclose (handle);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,148 @@
+/* Test that the directory cache of the dynamic linker sees new files.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xstdio.h>
+#include <support/xunistd.h>
+
+/* tst-dircachemod.so has this directory on its search path.  */
+static const char testdir[] = PFX "tst-dircache-dir";
+static const char newlib[] = PFX "tst-dircache-dir/tst-dircache-new.so";
+static const char missing[] = PFX "tst-dircache-dir/tst-dircache-missing.so";
+
+static void *(*mod_dlopen) (const char *);
+
+/* Copy FROM to TO.  */
+static void
+copy_file (const char *from, const char *to)
+{
+  int in = xopen (from, O_RDONLY, 0);
+  int out = xopen (to, O_WRONLY | O_CREAT | O_EXCL, 0755);
+  char buf[4096];
+  ssize_t n;
+  while ((n = read (in, buf, sizeof (buf))) > 0)
+    xwrite (out, buf, n);
+  TEST_VERIFY_EXIT (n == 0);
+  xclose (out);
+  xclose (in);
+}
+
+/* Count the lines in the LD_DEBUG output FP, from its current
+   position on, which show that the test directory has been read, that
+   MISSING has been tried, and that it has been skipped because it was
+   not in the cached directory contents.  */
+static void
+count_lines (FILE *fp, int *reads, int *tries, int *skipped)
+{
+  *reads = *tries = *skipped = 0;
+  char *dirline = xasprintf ("reading directory=%s/\n", testdir);
+  char *line = NULL;
+  size_t linelen = 0;
+  while (getline (&line, &linelen, fp) > 0)
+    {
+      if (strstr (line, dirline) != NULL)
+	++*reads;
+      char *p = strstr (line, "trying file=");
+      if (p == NULL)
+	continue;
+      p += strlen ("trying file=");
+      size_t len = strlen (missing);
+      if (strncmp (p, missing, len) != 0)
+	continue;
+      ++*tries;
+      if (strcmp (p + len, " (not in directory)\n") == 0)
+	++*skipped;
+    }
+  free (line);
+  free (dirline);
+  clearerr (fp);
+}
+
+static int
+do_test (void)
+{
+  const char *output = getenv ("LD_DEBUG_OUTPUT");
+  if (output == NULL)
+    FAIL_UNSUPPORTED ("LD_DEBUG_OUTPUT not set");
+
+  /* Start with an empty directory.  It has to exist before the
+     module is loaded, or the dynamic linker remembers that it does
+     not exist.  */
+  unlink (newlib);
+  unlink (missing);
+  if (mkdir (testdir, 0777) != 0 && errno != EEXIST)
+    FAIL_EXIT1 ("cannot create %s: %m", testdir);
+
+  void *mod = dlopen ("tst-dircachemod.so", RTLD_NOW);
+  if (mod == NULL)
+    FAIL_EXIT1 ("dlopen (\"tst-dircachemod.so\"): %s", dlerror ());
+  mod_dlopen = dlsym (mod, "dircache_dlopen");
+  TEST_VERIFY_EXIT (mod_dlopen != NULL);
+
+  /* The first lookup reads the directory.  The file is created
+     immediately afterwards, possibly in the same clock tick, which
+     does not change the modification time of the directory.  */
+  TEST_VERIFY (mod_dlopen ("tst-dircache-new.so") == NULL);
+  copy_file (PFX "tst-dircachemod.so", newlib);
+  void *h = mod_dlopen ("tst-dircache-new.so");
+  if (h == NULL)
+    FAIL_EXIT1 ("new object not found: %s", dlerror ());
+  TEST_VERIFY (dlsym (h, "dircache_dlopen") != NULL);
+  TEST_VERIFY (dlclose (h) == 0);
+
+  /* Wait until the clock has advanced past the modification of the
+     directory, then have the directory read again.  */
+  struct timespec ts = { 0, 100 * 1000 * 1000 };
+  nanosleep (&ts, NULL);
+  TEST_VERIFY (mod_dlopen ("tst-dircache-missing.so") == NULL);
+
+  /* The dynamic linker appends the process ID to the file name.  */
+  char *path = xasprintf ("%s.%d", output, (int) getpid ());
+  FILE *fp = xfopen (path, "r");
+  int reads, tries, skipped;
+  count_lines (fp, &reads, &tries, &skipped);
+  TEST_VERIFY (reads > 0);
+
+  /* Looking up a missing object again must use the cached contents.
+     The search may still be repeated if other directories on the
+     search path are being modified concurrently.  */
+  TEST_VERIFY (mod_dlopen ("tst-dircache-missing.so") == NULL);
+  count_lines (fp, &reads, &tries, &skipped);
+  TEST_VERIFY (reads == 0);
+  TEST_VERIFY (tries > 0);
+  TEST_VERIFY (skipped == tries);
+
+  xfclose (fp);
+  free (path);
+  TEST_VERIFY (dlclose (mod) == 0);
+  unlink (newlib);
+  rmdir (testdir);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,119 @@
+/* Basic tests for _dl_find_object.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <link.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Check that ADDRESS is found in the object loaded as MAP.  */
+static void
+check (void *address, struct link_map *map, const char *what)
+{
+  struct dl_find_object dlfo;
+  if (_dl_find_object (address, &dlfo) != 0)
+    FAIL_EXIT1 ("%s: address %p not found", what, address);
+  if (dlfo.dlfo_link_map != map)
+    FAIL_EXIT1 ("%s: wrong link map %p (expected %p)",
+		what, dlfo.dlfo_link_map, map);
+  if (address < dlfo.dlfo_map_start || address >= dlfo.dlfo_map_end)
+    FAIL_EXIT1 ("%s: address %p outside of [%p, %p)",
+		what, address, dlfo.dlfo_map_start, dlfo.dlfo_map_end);
+  if (dlfo.dlfo_flags != 0)
+    FAIL_EXIT1 ("%s: unexpected flags %llx", what, dlfo.dlfo_flags);
+  if (dlfo.dlfo_eh_frame != NULL
+      && ((void *) dlfo.dlfo_eh_frame < dlfo.dlfo_map_start
+	  || (void *) dlfo.dlfo_eh_frame >= dlfo.dlfo_map_end))
+    FAIL_EXIT1 ("%s: PT_GNU_EH_FRAME %p outside of mapping",
+		what, dlfo.dlfo_eh_frame);
+}
+
+static struct link_map *
+map_of (void *handle)
+{
+  struct link_map *l;
+  if (dlinfo (handle, RTLD_DI_LINKMAP, &l) != 0)
+    FAIL_EXIT1 ("dlinfo: %s", dlerror ());
+  return l;
+}
+
+static int do_test (void);
+
+static int done;
+
+/* Look up the main program while the main thread keeps loading and
+   unloading an object.  */
+static void *
+lookup_thread (void *closure)
+{
+  struct link_map *main_map = closure;
+  while (!atomic_load_relaxed (&done))
+    check (&do_test, main_map, "main program (concurrent)");
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  void *self = dlopen (NULL, RTLD_NOW);
+  if (self == NULL)
+    FAIL_EXIT1 ("dlopen (NULL): %s", dlerror ());
+  struct link_map *main_map = map_of (self);
+  check (&do_test, main_map, "main program");
+
+  void *libc = dlopen (LIBC_SO, RTLD_NOW | RTLD_NOLOAD);
+  if (libc == NULL)
+    FAIL_EXIT1 ("dlopen (LIBC_SO): %s", dlerror ());
+  /* Use dlsym because &malloc may refer to a PLT stub in the main
+     program.  */
+  void *sym = dlsym (libc, "malloc");
+  if (sym == NULL)
+    FAIL_EXIT1 ("dlsym: %s", dlerror ());
+  check (sym, map_of (libc), "libc");
+  dlclose (libc);
+
+  /* An address outside of all objects.  */
+  struct dl_find_object dlfo;
+  int local;
+  TEST_VERIFY (_dl_find_object (&local, &dlfo) == -1);
+
+  pthread_t thr = xpthread_create (NULL, lookup_thread, main_map);
+  for (int i = 0; i < 100; ++i)
+    {
+      void *libm = dlopen (LIBM_SO, RTLD_NOW);
+      if (libm == NULL)
+	FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+      sym = dlsym (libm, "cos");
+      if (sym == NULL)
+	FAIL_EXIT1 ("dlsym: %s", dlerror ());
+      check (sym, map_of (libm), "libm");
+      TEST_VERIFY_EXIT (dlclose (libm) == 0);
+      TEST_VERIFY (_dl_find_object (sym, &dlfo) == -1);
+    }
+  atomic_store_relaxed (&done, 1);
+  xpthread_join (thr);
+
+  dlclose (self);
+  return 0;
+}
+
+#include <support/test-driver.c>
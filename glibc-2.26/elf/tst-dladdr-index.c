@@ -0,0 +1,77 @@
+/* Test repeated dladdr lookups, which use the per-object symbol index.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <link.h>
+#include <string.h>
+#include <support/check.h>
+
+static const char *const names[] =
+  {
+    "cos", "sin", "tan", "exp", "log", "pow", "sqrt", "floor", "ceil",
+    "fabs", "atan2", "hypot", "frexp", "ldexp", "modf", "fmod"
+  };
+
+/* Check that dladdr maps ADDRESS back to the symbol NAME at SYM.  */
+static void
+check (void *handle, void *address, const char *name, void *sym)
+{
+  Dl_info info;
+  struct link_map *map;
+  if (dladdr1 (address, &info, (void **) &map, RTLD_DL_LINKMAP) == 0)
+    FAIL_EXIT1 ("dladdr (%p) failed for %s", address, name);
+  if (info.dli_saddr != sym)
+    FAIL_EXIT1 ("dladdr (%p): dli_saddr %p, expected %p (%s)",
+		address, info.dli_saddr, sym, name);
+  if (info.dli_sname == NULL)
+    FAIL_EXIT1 ("dladdr (%p): no symbol name for %s", address, name);
+  /* Aliases may be reported instead of NAME, but they must resolve to
+     the same address.  */
+  if (strcmp (info.dli_sname, name) != 0
+      && dlsym (handle, info.dli_sname) != sym)
+    FAIL_EXIT1 ("dladdr (%p): %s is not an alias of %s",
+		address, info.dli_sname, name);
+}
+
+static int
+do_test (void)
+{
+  /* Load and unload the object several times, so that the index is
+     built for a fresh link map each time.  */
+  for (int round = 0; round < 3; ++round)
+    {
+      void *handle = dlopen (LIBM_SO, RTLD_NOW);
+      if (handle == NULL)
+	FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+
+      for (int repeat = 0; repeat < 2; ++repeat)
+	for (size_t i = 0; i < sizeof (names) / sizeof (names[0]); ++i)
+	  {
+	    void *sym = dlsym (handle, names[i]);
+	    if (sym == NULL)
+	      FAIL_EXIT1 ("dlsym (%s): %s", names[i], dlerror ());
+	    check (handle, sym, names[i], sym);
+	  }
+
+      TEST_VERIFY_EXIT (dlclose (handle) == 0);
+    }
+  return 0;
+}
+
+#include <support/test-driver.c>
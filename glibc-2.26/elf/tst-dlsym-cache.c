@@ -0,0 +1,118 @@
+/* Test repeated and concurrent dlsym calls on a handle.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <stddef.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Enough names to make the cache grow a few times.  None of them is
+   also defined in libc.so, so the global scope finds the same
+   definitions as the handle.  */
+static const char *const names[] =
+  {
+    "acos", "asin", "atan", "atan2", "cos", "sin", "tan", "cosh", "sinh",
+    "tanh", "acosh", "asinh", "atanh", "exp", "exp2", "expm1", "log",
+    "log10", "log1p", "log2", "logb", "pow", "sqrt", "cbrt", "hypot",
+    "erf", "erfc", "lgamma", "tgamma", "ceil", "floor", "fmod", "trunc",
+    "round", "rint", "nearbyint", "remainder", "fdim", "fmax", "fmin",
+    "fma", "lrint", "llrint", "lround", "llround",
+  };
+#define NNAMES (sizeof (names) / sizeof (names[0]))
+
+static void *handle;
+static void *expected[NNAMES];
+
+static void *
+lookup_thread (void *closure)
+{
+  for (int round = 0; round < 200; ++round)
+    for (size_t i = 0; i < NNAMES; ++i)
+      {
+	void *sym = dlsym (handle, names[i]);
+	if (sym != expected[i])
+	  FAIL_EXIT1 ("dlsym (%s): %p, expected %p",
+		      names[i], sym, expected[i]);
+      }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  handle = dlopen (LIBM_SO, RTLD_NOW | RTLD_GLOBAL);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+
+  /* Lookups in the global scope are not cached.  */
+  for (size_t i = 0; i < NNAMES; ++i)
+    {
+      expected[i] = dlsym (RTLD_DEFAULT, names[i]);
+      if (expected[i] == NULL)
+	FAIL_EXIT1 ("dlsym (RTLD_DEFAULT, %s): %s", names[i], dlerror ());
+    }
+
+  /* Only look up half of the names in the handle first, so that the
+     threads add the other half concurrently.  */
+  for (size_t i = 0; i < NNAMES / 2; ++i)
+    TEST_VERIFY (dlsym (handle, names[i]) == expected[i]);
+
+  pthread_t threads[4];
+  for (int i = 0; i < 4; ++i)
+    threads[i] = xpthread_create (NULL, lookup_thread, NULL);
+  for (int i = 0; i < 4; ++i)
+    xpthread_join (threads[i]);
+
+  /* Failed lookups are not cached.  */
+  for (int i = 0; i < 2; ++i)
+    {
+      TEST_VERIFY (dlsym (handle, "no_such_symbol") == NULL);
+      TEST_VERIFY (dlerror () != NULL);
+    }
+
+  TEST_VERIFY (dlclose (handle) == 0);
+
+  /* The cache does not survive the object.  */
+  handle = dlopen (LIBM_SO, RTLD_NOW);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+  for (size_t i = 0; i < NNAMES; ++i)
+    TEST_VERIFY (dlsym (handle, names[i]) != NULL);
+  TEST_VERIFY (dlclose (handle) == 0);
+
+  /* The scope of the main program grows and shrinks with RTLD_GLOBAL
+     objects, so lookups in it must not be cached.  */
+  void *main_handle = dlopen (NULL, RTLD_NOW);
+  if (main_handle == NULL)
+    FAIL_EXIT1 ("dlopen (NULL): %s", dlerror ());
+  TEST_VERIFY (dlsym (main_handle, "cbrt") == NULL);
+  handle = dlopen (LIBM_SO, RTLD_NOW | RTLD_GLOBAL);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+  void *sym = dlsym (main_handle, "cbrt");
+  TEST_VERIFY (sym != NULL);
+  TEST_VERIFY (dlsym (main_handle, "cbrt") == sym);
+  TEST_VERIFY (dlclose (handle) == 0);
+  TEST_VERIFY (dlsym (main_handle, "cbrt") == NULL);
+  TEST_VERIFY (dlclose (main_handle) == 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,156 @@
+/* Test the hash table in ld.so.cache.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldconfig.h>
+#include <dl-cache.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+
+/* Used by cache.c.  Write only the new format, so that the file starts
+   with struct cache_file_new.  */
+int opt_verbose;
+int opt_format = 2;
+
+#define DIR "/tst-ldcache-hash"
+
+/* These two names have the same hash.  */
+#define COLLISION1 "libcoll139599.so"
+#define COLLISION2 "libcoll322382.so"
+
+/* The number of other names.  With these, names also share slots.  */
+#define NFILL 200
+
+static const struct cache_file_new *cache;
+static size_t cache_size;
+static const struct cache_hash_table *table;
+
+/* Look up NAME through the hash table.  Check that the slot found only
+   covers entries for NAME, and that the first one has the file name
+   DIR/FILE.  Return the number of entries, or 0 if NAME is not
+   found.  */
+static uint32_t
+lookup (const char *name, const char *file)
+{
+  const struct cache_hash_slot *slot
+    = _dl_cache_hash_lookup (cache, cache_size, table, name);
+  if (slot == NULL)
+    return 0;
+
+  TEST_VERIFY (slot->hash == _dl_cache_hash (name));
+  for (uint32_t i = slot->first - 1; i < slot->first - 1 + slot->count; ++i)
+    TEST_VERIFY (_dl_cache_libcmp (name, (const char *) cache
+				   + cache->libs[i].key) == 0);
+
+  char *path = xasprintf ("%s/%s", DIR, file);
+  const char *value
+    = (const char *) cache + cache->libs[slot->first - 1].value;
+  if (strcmp (value, path) != 0)
+    {
+      support_record_failure ();
+      printf ("error: %s: found %s, expected %s\n", name, value, path);
+    }
+  free (path);
+  return slot->count;
+}
+
+static int
+do_test (void)
+{
+  TEST_VERIFY_EXIT (_dl_cache_hash (COLLISION1)
+		    == _dl_cache_hash (COLLISION2));
+
+  init_cache ();
+  for (int i = 0; i < NFILL; ++i)
+    {
+      char *name = xasprintf ("libfill%d.so.1", i);
+      add_to_cache (DIR, name, FLAG_ELF_LIBC6, 0, 0);
+      free (name);
+    }
+  add_to_cache (DIR, COLLISION1, FLAG_ELF_LIBC6, 0, 0);
+  add_to_cache (DIR, COLLISION2, FLAG_ELF_LIBC6, 0, 0);
+  /* Two entries for the same name, as for hwcap subdirectories.  The
+     one with more hwcap bits is sorted first.  */
+  add_to_cache (DIR, "libtwo.so.1", FLAG_ELF_LIBC6, 0, 0);
+  add_to_cache (DIR "/tls", "libtwo.so.1", FLAG_ELF_LIBC6, 0, 1ULL << 63);
+
+  char *cache_name;
+  xclose (create_temp_file ("tst-ldcache-hash-", &cache_name));
+  save_cache (cache_name);
+
+  int fd = xopen (cache_name, O_RDONLY, 0);
+  struct stat64 st;
+  TEST_VERIFY_EXIT (fstat64 (fd, &st) == 0);
+  cache_size = st.st_size;
+  char *buf = xmalloc (cache_size);
+  TEST_VERIFY_EXIT (read (fd, buf, cache_size) == (ssize_t) cache_size);
+  xclose (fd);
+  TEST_VERIFY_EXIT (cache_size > sizeof (struct cache_file_new));
+  TEST_VERIFY_EXIT (memcmp (buf, CACHEMAGIC_VERSION_NEW,
+			    sizeof CACHEMAGIC_VERSION_NEW - 1) == 0);
+  cache = (const struct cache_file_new *) buf;
+  TEST_VERIFY_EXIT (cache->nlibs == NFILL + 4);
+
+  table = _dl_cache_hash_table (cache, cache_size);
+  TEST_VERIFY_EXIT (table != NULL);
+
+  /* Hits.  */
+  for (int i = 0; i < NFILL; ++i)
+    {
+      char *name = xasprintf ("libfill%d.so.1", i);
+      TEST_VERIFY (lookup (name, name) == 1);
+      free (name);
+    }
+  TEST_VERIFY (lookup ("libtwo.so.1", "tls/libtwo.so.1") == 2);
+  /* _dl_cache_libcmp compares numbers by value.  */
+  TEST_VERIFY (lookup ("libtwo.so.01", "tls/libtwo.so.1") == 2);
+
+  /* Names with the same hash are told apart by the name comparison.  */
+  TEST_VERIFY (lookup (COLLISION1, COLLISION1) == 1);
+  TEST_VERIFY (lookup (COLLISION2, COLLISION2) == 1);
+
+  /* Misses.  */
+  TEST_VERIFY (lookup ("libmissing.so.1", NULL) == 0);
+  TEST_VERIFY (lookup ("libfill.so.1", NULL) == 0);
+  TEST_VERIFY (lookup ("libtwo.so", NULL) == 0);
+
+  /* Every entry can be found through the table.  */
+  for (uint32_t i = 0; i < cache->nlibs; ++i)
+    {
+      const char *name = (const char *) cache + cache->libs[i].key;
+      const struct cache_hash_slot *slot
+	= _dl_cache_hash_lookup (cache, cache_size, table, name);
+      TEST_VERIFY (slot != NULL
+		   && slot->first - 1 <= i && i < slot->first - 1 + slot->count);
+    }
+
+  /* A table which does not fit into the file is not used.  */
+  TEST_VERIFY (_dl_cache_hash_table (cache, cache_size - 1) == NULL);
+
+  free (buf);
+  free (cache_name);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,81 @@
+#!/bin/sh
+# Test that ldconfig produces the same cache with any number of jobs,
+# and that it reuses the auxiliary cache for unchanged libraries.
+# Copyright (C) 2017 Free Software Foundation, Inc.
+# This file is part of the GNU C Library.
+
+# The GNU C Library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+
+# The GNU C Library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public
+# License along with the GNU C Library; if not, see
+# <http://www.gnu.org/licenses/>.
+
+set -ex
+
+common_objpfx=$1
+test_wrapper_env=$2
+run_program_env=$3
+
+testroot="${common_objpfx}elf/tst-ldconfig-jobs-directory"
+cleanup () {
+    rm -rf "$testroot"
+}
+trap cleanup 0
+
+rm -rf "$testroot"
+mkdir -p $testroot/lib $testroot/etc $testroot/var/cache/ldconfig
+: > $testroot/etc/ld.so.conf
+
+cp ${common_objpfx}libc.so $testroot/lib/libc-test.so
+cp ${common_objpfx}math/libm.so $testroot/lib/libm-test.so
+cp ${common_objpfx}dlfcn/libdl.so $testroot/lib/libdl-test.so
+cp ${common_objpfx}elf/ld.so $testroot/lib/ld-test.so
+# Several names for the same file.
+ln $testroot/lib/libm-test.so $testroot/lib/libm-hardlink.so
+ln -s libc-test.so $testroot/lib/libc-symlink.so
+
+run_ldconfig () {
+    ${test_wrapper_env} \
+    ${run_program_env} \
+    ${common_objpfx}elf/ldconfig "$@"
+}
+
+# The number of jobs does not change the result.
+run_ldconfig -X -f /dev/null -C $testroot/etc/cache.1 -j 1 $testroot/lib
+run_ldconfig -X -f /dev/null -C $testroot/etc/cache.4 -j 4 $testroot/lib
+cmp $testroot/etc/cache.1 $testroot/etc/cache.4
+
+# The first run writes the auxiliary cache, the second one uses it.
+run_ldconfig -X -r $testroot -j 4 /lib
+test -s $testroot/var/cache/ldconfig/aux-cache
+cp $testroot/etc/ld.so.cache $testroot/etc/cache.first
+run_ldconfig -X -r $testroot -j 4 /lib
+cmp $testroot/etc/cache.first $testroot/etc/ld.so.cache
+
+# A library which has been replaced is read again.
+rm $testroot/lib/libm-hardlink.so
+cp $testroot/lib/libdl-test.so $testroot/lib/libm-test.so.new
+mv $testroot/lib/libm-test.so.new $testroot/lib/libm-test.so
+run_ldconfig -X -r $testroot -j 4 /lib
+run_ldconfig -p -C $testroot/etc/ld.so.cache > $testroot/cache.out
+cat $testroot/cache.out
+
+errors=0
+if grep -q 'libm\.so' $testroot/cache.out ; then
+    echo "error: stale entry for libm-test.so"
+    errors=1
+fi
+if ! grep -q 'libdl\.so' $testroot/cache.out ; then
+    echo "error: missing entry for libdl-test.so"
+    errors=1
+fi
+
+exit $errors
@@ -0,0 +1,70 @@
+/* Test the glibc.rtld.prefault tunable.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <support/check.h>
+
+/* Return the number of minor page faults of the process so far.  */
+static long int
+minor_faults (void)
+{
+  struct rusage ru;
+  if (getrusage (RUSAGE_SELF, &ru) != 0)
+    FAIL_EXIT1 ("getrusage: %m");
+  return ru.ru_minflt;
+}
+
+static int
+do_test (void)
+{
+  long int pagesize = sysconf (_SC_PAGESIZE);
+
+  void *handle = dlopen ("tst-prefaultmod.so", RTLD_NOW);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (tst-prefaultmod.so): %s", dlerror ());
+  char *data = dlsym (handle, "prefault_data");
+  if (data == NULL)
+    FAIL_EXIT1 ("dlsym (prefault_data): %s", dlerror ());
+
+  /* Writing to the pages of the module does not fault because they
+     have been copied when the module was loaded.  Allow for some
+     unrelated faults.  */
+  size_t npages = (1 << 20) / pagesize;
+  long int before = minor_faults ();
+  for (size_t i = 0; i < npages; ++i)
+    data[i * pagesize] = i;
+  long int faults = minor_faults () - before;
+  printf ("info: %ld minor faults for %zu pages\n", faults, npages);
+  TEST_VERIFY ((size_t) faults < npages / 2);
+
+  /* Objects which are not listed are loaded normally.  */
+  void *libm = dlopen (LIBM_SO, RTLD_NOW);
+  if (libm == NULL)
+    FAIL_EXIT1 ("dlopen (LIBM_SO): %s", dlerror ());
+  TEST_VERIFY (dlsym (libm, "cos") != NULL);
+
+  TEST_VERIFY (dlclose (libm) == 0);
+  TEST_VERIFY (dlclose (handle) == 0);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,127 @@
+/* Test the sampling profiler selected by glibc.rtld.profile_sample.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/gmon.h>
+#include <sys/gmon_out.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xstdio.h>
+#include <support/xthread.h>
+
+#define MODULE "tst-profile-samplemod.so"
+
+static unsigned long int (*spin) (unsigned long int);
+
+/* Return the CPU time used by the process, in nanoseconds.  */
+static long long int
+cpu_time (void)
+{
+  struct timespec ts;
+  if (clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+    FAIL_EXIT1 ("clock_gettime: %m");
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *
+spin_thread (void *closure)
+{
+  long long int end = cpu_time () + 500000000LL;
+  while (cpu_time () < end)
+    spin (100000);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  const char *output = getenv ("LD_PROFILE_OUTPUT");
+  if (output == NULL)
+    FAIL_UNSUPPORTED ("LD_PROFILE_OUTPUT not set");
+
+  /* Start with an empty histogram.  */
+  char *path = xasprintf ("%s/%s.profile", output, MODULE);
+  unlink (path);
+
+  void *handle = dlopen (MODULE, RTLD_NOW);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (%s): %s", MODULE, dlerror ());
+  spin = dlsym (handle, "spin");
+  if (spin == NULL)
+    FAIL_EXIT1 ("dlsym (spin): %s", dlerror ());
+
+  pthread_t threads[2];
+  for (int i = 0; i < 2; ++i)
+    threads[i] = xpthread_create (NULL, spin_thread, NULL);
+  for (int i = 0; i < 2; ++i)
+    xpthread_join (threads[i]);
+
+  /* The file contains the header, the histogram and the list of arcs,
+     which is empty unless LD_PROFILE has created the file.  */
+  FILE *fp = xfopen (path, "r");
+  struct gmon_hdr hdr;
+  uint32_t tag;
+  struct gmon_hist_hdr hist;
+  TEST_VERIFY_EXIT (fread (&hdr, sizeof (hdr), 1, fp) == 1);
+  TEST_VERIFY (memcmp (hdr.cookie, GMON_MAGIC, sizeof (hdr.cookie)) == 0);
+  TEST_VERIFY_EXIT (fread (&tag, sizeof (tag), 1, fp) == 1);
+  TEST_VERIFY (tag == GMON_TAG_TIME_HIST);
+  TEST_VERIFY_EXIT (fread (&hist, sizeof (hist), 1, fp) == 1);
+
+  int32_t hist_size;
+  memcpy (&hist_size, hist.hist_size, sizeof (hist_size));
+  TEST_VERIFY_EXIT (hist_size > 0);
+  unsigned long int samples = 0;
+  for (int32_t i = 0; i < hist_size; ++i)
+    {
+      HISTCOUNTER count;
+      TEST_VERIFY_EXIT (fread (&count, sizeof (count), 1, fp) == 1);
+      samples += count;
+    }
+  printf ("info: %lu samples in %d buckets\n", samples, (int) hist_size);
+  TEST_VERIFY (samples > 0);
+
+  uint32_t narcs;
+  TEST_VERIFY_EXIT (fread (&tag, sizeof (tag), 1, fp) == 1);
+  TEST_VERIFY (tag == GMON_TAG_CG_ARC);
+  TEST_VERIFY_EXIT (fread (&narcs, sizeof (narcs), 1, fp) == 1);
+#ifndef PROFILE_ARCS
+  TEST_VERIFY (narcs == 0);
+  TEST_VERIFY (fgetc (fp) == EOF);
+#endif
+  xfclose (fp);
+
+  /* Loading the object again reuses its histogram.  */
+  TEST_VERIFY (dlclose (handle) == 0);
+  handle = dlopen (MODULE, RTLD_NOW);
+  if (handle == NULL)
+    FAIL_EXIT1 ("dlopen (%s): %s", MODULE, dlerror ());
+  TEST_VERIFY (dlclose (handle) == 0);
+
+  unlink (path);
+  free (path);
+  return 0;
+}
+
+#include <support/test-driver.c>
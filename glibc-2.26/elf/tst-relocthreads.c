@@ -0,0 +1,103 @@
+/* Test relocation of the initial objects on helper threads.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <link.h>
+#include <stdio.h>
+#include <string.h>
+#include <support/check.h>
+
+#include "tst-relocthreads.h"
+
+/* The test is run with glibc.rtld.relocation_threads set.
+   tst-relocthreadsmod2.so to tst-relocthreadsmod5.so only depend on
+   tst-relocthreadsmod1.so and can be relocated concurrently.  They
+   reference IFUNC symbols in libc.so.6 and tst-relocthreadsmod5.so
+   defines IFUNC symbols of its own, so the relocations against them
+   have to be applied correctly after the parallel pass.  Which thread
+   relocates a module depends on the scheduling and is only printed.  */
+
+extern int mod1_var;
+extern int mod1_func (void);
+
+#define DECLARE_MOD(n)					\
+  extern int mod##n##_var;				\
+  extern int *mod##n##_ptr;				\
+  extern int (*mod##n##_fptr) (void);			\
+  extern int mod##n##_func (void);			\
+  extern int *const mod##n##_table[];
+DECLARE_MOD (2)
+DECLARE_MOD (3)
+DECLARE_MOD (4)
+DECLARE_MOD (5)
+
+extern size_t mod2_strlen (const char *);
+extern void *(*mod3_memcpy) (void *, const void *, size_t);
+#ifdef HAVE_IFUNC
+extern int mod5_ifunc (void);
+extern int (*mod5_local_ptr) (void);
+#endif
+
+#define CHECK_MOD(n)							\
+  do									\
+    {									\
+      TEST_VERIFY (mod##n##_var == n);					\
+      TEST_VERIFY (mod##n##_ptr == &mod1_var);				\
+      TEST_VERIFY (mod##n##_fptr == &mod1_func);			\
+      TEST_VERIFY (mod##n##_func () == n);				\
+      TEST_VERIFY (mod##n##_table[0] == &mod1_v##n##_000000);		\
+      TEST_VERIFY (mod##n##_table[1] == &mod1_v##n##_000001);		\
+      TEST_VERIFY (mod##n##_table[RELOCTHREADS_COUNT - 1]		\
+		   == &mod1_v##n##_333333);				\
+    }									\
+  while (0)
+
+static int
+do_test (void)
+{
+  TEST_VERIFY (mod1_var == 1);
+  TEST_VERIFY (mod1_func () == 1);
+  CHECK_MOD (2);
+  CHECK_MOD (3);
+  CHECK_MOD (4);
+  CHECK_MOD (5);
+
+  /* Calls through IFUNC symbols in libc.  */
+  char buf[16];
+  memcpy (buf, "relocation", sizeof ("relocation"));
+  TEST_VERIFY (strlen (buf) == strlen ("relocation"));
+  TEST_VERIFY (strcmp (buf, "relocation") == 0);
+
+  /* IFUNC relocations in the modules.  */
+  TEST_VERIFY (mod2_strlen (buf) == strlen ("relocation"));
+  char copy[16];
+  TEST_VERIFY (mod3_memcpy (copy, buf, sizeof ("relocation")) == copy);
+  TEST_VERIFY (strcmp (copy, "relocation") == 0);
+#ifdef HAVE_IFUNC
+  TEST_VERIFY (mod5_ifunc () == 5);
+  TEST_VERIFY (mod5_local_ptr () == 5);
+#endif
+
+  for (struct link_map *l = _r_debug.r_map; l != NULL; l = l->l_next)
+    if (strstr (l->l_name, "tst-relocthreadsmod") != NULL)
+      printf ("info: %s relocated by thread %u\n",
+	      l->l_name, l->l_reloc_helper);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,51 @@
+/* Common definitions for tst-relocthreads and its modules.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* tst-relocthreadsmod1.so defines RELOCTHREADS_COUNT variables for each
+   of the other modules, and each of them contains a table of pointers
+   to its own set.  Every entry needs a symbol lookup of its own, so
+   that relocating a module takes long enough for the helper threads to
+   pick up the other modules.  */
+
+#define RELOCTHREADS_4(m, p) m (p##0) m (p##1) m (p##2) m (p##3)
+#define RELOCTHREADS_16(m, p) \
+  RELOCTHREADS_4 (m, p##0) RELOCTHREADS_4 (m, p##1) \
+  RELOCTHREADS_4 (m, p##2) RELOCTHREADS_4 (m, p##3)
+#define RELOCTHREADS_64(m, p) \
+  RELOCTHREADS_16 (m, p##0) RELOCTHREADS_16 (m, p##1) \
+  RELOCTHREADS_16 (m, p##2) RELOCTHREADS_16 (m, p##3)
+#define RELOCTHREADS_256(m, p) \
+  RELOCTHREADS_64 (m, p##0) RELOCTHREADS_64 (m, p##1) \
+  RELOCTHREADS_64 (m, p##2) RELOCTHREADS_64 (m, p##3)
+#define RELOCTHREADS_1024(m, p) \
+  RELOCTHREADS_256 (m, p##0) RELOCTHREADS_256 (m, p##1) \
+  RELOCTHREADS_256 (m, p##2) RELOCTHREADS_256 (m, p##3)
+#define RELOCTHREADS_4096(m, p) \
+  RELOCTHREADS_1024 (m, p##0) RELOCTHREADS_1024 (m, p##1) \
+  RELOCTHREADS_1024 (m, p##2) RELOCTHREADS_1024 (m, p##3)
+
+#define RELOCTHREADS_COUNT 4096
+#define RELOCTHREADS_DECLARE(name) extern int name;
+RELOCTHREADS_4096 (RELOCTHREADS_DECLARE, mod1_v2_)
+RELOCTHREADS_4096 (RELOCTHREADS_DECLARE, mod1_v3_)
+RELOCTHREADS_4096 (RELOCTHREADS_DECLARE, mod1_v4_)
+RELOCTHREADS_4096 (RELOCTHREADS_DECLARE, mod1_v5_)
+
+#define RELOCTHREADS_REF(name) &name,
+#define RELOCTHREADS_TABLE(prefix) \
+  { RELOCTHREADS_4096 (RELOCTHREADS_REF, prefix) }
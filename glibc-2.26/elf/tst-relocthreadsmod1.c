@@ -0,0 +1,33 @@
+/* Base module for tst-relocthreads.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include "tst-relocthreads.h"
+
+int mod1_var = 1;
+
+int
+mod1_func (void)
+{
+  return 1;
+}
+
+#define DEFINE_VAR(name) int name;
+RELOCTHREADS_4096 (DEFINE_VAR, mod1_v2_)
+RELOCTHREADS_4096 (DEFINE_VAR, mod1_v3_)
+RELOCTHREADS_4096 (DEFINE_VAR, mod1_v4_)
+RELOCTHREADS_4096 (DEFINE_VAR, mod1_v5_)
@@ -0,0 +1,43 @@
+/* Module for tst-relocthreads which depends on tst-relocthreadsmod1.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+#include "tst-relocthreads.h"
+
+extern int mod1_var;
+extern int mod1_func (void);
+
+int mod2_var = 2;
+int *mod2_ptr = &mod1_var;
+int (*mod2_fptr) (void) = &mod1_func;
+int *const mod2_table[RELOCTHREADS_COUNT]
+  = RELOCTHREADS_TABLE (mod1_v2_);
+
+int
+mod2_func (void)
+{
+  return mod1_func () + 1;
+}
+
+/* Calls the IFUNC symbol strlen in libc.so.6 through the PLT.  */
+size_t
+mod2_strlen (const char *s)
+{
+  return strlen (s);
+}
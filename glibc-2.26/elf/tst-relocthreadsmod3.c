@@ -0,0 +1,39 @@
+/* Module for tst-relocthreads which depends on tst-relocthreadsmod1.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+#include "tst-relocthreads.h"
+
+extern int mod1_var;
+extern int mod1_func (void);
+
+int mod3_var = 3;
+int *mod3_ptr = &mod1_var;
+int (*mod3_fptr) (void) = &mod1_func;
+int *const mod3_table[RELOCTHREADS_COUNT]
+  = RELOCTHREADS_TABLE (mod1_v3_);
+
+/* Bound to the IFUNC symbol memcpy in libc.so.6.  */
+void *(*mod3_memcpy) (void *, const void *, size_t) = memcpy;
+
+int
+mod3_func (void)
+{
+  return mod1_func () + 2;
+}
@@ -0,0 +1,34 @@
+/* Module for tst-relocthreads which depends on tst-relocthreadsmod1.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include "tst-relocthreads.h"
+
+extern int mod1_var;
+extern int mod1_func (void);
+
+int mod4_var = 4;
+int *mod4_ptr = &mod1_var;
+int (*mod4_fptr) (void) = &mod1_func;
+int *const mod4_table[RELOCTHREADS_COUNT]
+  = RELOCTHREADS_TABLE (mod1_v4_);
+
+int
+mod4_func (void)
+{
+  return mod1_func () + 3;
+}
@@ -0,0 +1,69 @@
+/* Module for tst-relocthreads which depends on tst-relocthreadsmod1.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include "tst-relocthreads.h"
+
+extern int mod1_var;
+extern int mod1_func (void);
+
+int mod5_var = 5;
+int *mod5_ptr = &mod1_var;
+int (*mod5_fptr) (void) = &mod1_func;
+int *const mod5_table[RELOCTHREADS_COUNT]
+  = RELOCTHREADS_TABLE (mod1_v5_);
+
+int
+mod5_func (void)
+{
+  return mod1_func () + 4;
+}
+
+#ifdef HAVE_IFUNC
+/* An exported IFUNC symbol, bound by the main program, and a local one
+   whose address is stored in a pointer, which needs an IRELATIVE
+   relocation.  Both are applied on the main thread.  */
+static int
+mod5_ifunc_impl (void)
+{
+  return 5;
+}
+
+void *mod5_ifunc_resolver (void) __asm__ ("mod5_ifunc");
+__asm__ (".type mod5_ifunc, %gnu_indirect_function");
+
+void *
+inhibit_stack_protector
+mod5_ifunc_resolver (void)
+{
+  return mod5_ifunc_impl;
+}
+
+extern int mod5_local (void);
+static void *mod5_local_resolver (void) __asm__ ("mod5_local");
+__asm__ (".type mod5_local, %gnu_indirect_function");
+
+static void *
+__attribute__ ((used))
+inhibit_stack_protector
+mod5_local_resolver (void)
+{
+  return mod5_ifunc_impl;
+}
+
+int (*mod5_local_ptr) (void) = mod5_local;
+#endif
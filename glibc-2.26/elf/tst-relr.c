@@ -0,0 +1,68 @@
+/* Test DT_RELR relative relocations.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <elf.h>
+#include <link.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <support/check.h>
+
+#include "tst-relrmod.h"
+
+static const int sparse_index[RELR_SPARSE] = { 1, 3, 5, 7, 11, 13, 17, 19 };
+
+/* Set to true if tst-relrmod.so has DT_RELR.  */
+static bool found_relr;
+
+static int
+callback (struct dl_phdr_info *info, size_t size, void *closure)
+{
+  /* The variables themselves may have been copied into the main
+     program, so look up the module by name.  */
+  if (strstr (info->dlpi_name, "tst-relrmod.so") == NULL)
+    return 0;
+
+  for (int i = 0; i < info->dlpi_phnum; ++i)
+    if (info->dlpi_phdr[i].p_type == PT_DYNAMIC)
+      for (const ElfW(Dyn) *d
+	     = (const void *) (info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+	   d->d_tag != DT_NULL; ++d)
+	if (d->d_tag == DT_RELR)
+	  found_relr = true;
+  return 1;
+}
+
+static int
+do_test (void)
+{
+  TEST_VERIFY (dl_iterate_phdr (callback, NULL) == 1);
+  TEST_VERIFY (found_relr);
+
+  for (int i = 0; i < RELR_DENSE; ++i)
+    TEST_VERIFY (relr_dense[i] == &relr_data[i]);
+  for (int i = 0; i < RELR_SPARSE; ++i)
+    {
+      TEST_VERIFY (relr_sparse[i].pointer == &relr_data[sparse_index[i]]);
+      TEST_VERIFY (relr_sparse[i].value == i + 1);
+    }
+  TEST_VERIFY (relr_far == &relr_data[42]);
+  return 0;
+}
+
+#include <support/test-driver.c>
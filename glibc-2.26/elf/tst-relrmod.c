@@ -0,0 +1,44 @@
+/* Module with relative relocations packed into DT_RELR.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include "tst-relrmod.h"
+
+int relr_data[RELR_DENSE];
+
+#define P(i) &relr_data[i]
+#define P10(i) P (i), P (i + 1), P (i + 2), P (i + 3), P (i + 4), \
+  P (i + 5), P (i + 6), P (i + 7), P (i + 8), P (i + 9)
+
+/* More consecutive relocations than fit into a single bitmap entry.  */
+int *relr_dense[RELR_DENSE] =
+  {
+    P10 (0), P10 (10), P10 (20), P10 (30), P10 (40),
+    P10 (50), P10 (60), P10 (70), P10 (80), P10 (90)
+  };
+
+/* Relocations separated by words which are not relocated.  */
+struct relr_sparse relr_sparse[RELR_SPARSE] =
+  {
+    { P (1), 1 }, { P (3), 2 }, { P (5), 3 }, { P (7), 4 },
+    { P (11), 5 }, { P (13), 6 }, { P (17), 7 }, { P (19), 8 }
+  };
+
+/* A relocation far away from the others, which needs a new address
+   entry.  */
+char relr_gap[4096] = { 1 };
+int *relr_far = P (42);
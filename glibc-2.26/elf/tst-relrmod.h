@@ -0,0 +1,31 @@
+/* Shared declarations for the DT_RELR test.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#define RELR_DENSE 100
+#define RELR_SPARSE 8
+
+struct relr_sparse
+{
+  int *pointer;
+  long int value;
+};
+
+extern int relr_data[RELR_DENSE];
+extern int *relr_dense[RELR_DENSE];
+extern struct relr_sparse relr_sparse[RELR_SPARSE];
+extern int *relr_far;
@@ -0,0 +1,94 @@
+/* Test placement of dlopen'ed TLS blocks in the static TLS surplus.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <string.h>
+#include <ldsodefs.h>
+#include <tls.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+static int *(*get_var) (void);
+static char *(*get_array) (void);
+
+/* Check that the TLS block of the module is in the static TLS block
+   of the calling thread.  */
+static void
+check_static (void *p)
+{
+#if TLS_TCB_AT_TP
+  size_t size;
+  size_t align;
+  _dl_get_tls_static_info (&size, &align);
+  char *tp = (char *) THREAD_SELF;
+  TEST_VERIFY ((char *) p < tp);
+  TEST_VERIFY ((char *) p >= tp - size);
+#endif
+}
+
+/* Check the initial values and that the data is thread-specific.  */
+static void *
+check_thread (void *closure)
+{
+  int *var = get_var ();
+  char *array = get_array ();
+  check_static (var);
+  check_static (array);
+
+  TEST_VERIFY (*var == 42);
+  for (int i = 0; i < 100; ++i)
+    TEST_VERIFY (array[i] == 0);
+
+  *var = (int) (long int) closure;
+  memset (array, *var, 100);
+  TEST_VERIFY (get_var () == var);
+  TEST_VERIFY (*get_var () == (int) (long int) closure);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  for (int round = 0; round < 2; ++round)
+    {
+      void *handle = dlopen ("tst-tls-optional-staticmod.so", RTLD_NOW);
+      if (handle == NULL)
+	FAIL_EXIT1 ("dlopen: %s", dlerror ());
+      get_var = dlsym (handle, "get_var");
+      get_array = dlsym (handle, "get_array");
+      if (get_var == NULL || get_array == NULL)
+	FAIL_EXIT1 ("dlsym: %s", dlerror ());
+
+      check_thread ((void *) 1L);
+
+      pthread_t threads[4];
+      for (long int i = 0; i < 4; ++i)
+	threads[i] = xpthread_create (NULL, check_thread, (void *) (i + 2));
+      for (int i = 0; i < 4; ++i)
+	xpthread_join (threads[i]);
+
+      TEST_VERIFY (*get_var () == 1);
+
+      /* The static TLS space is reused after dlclose.  */
+      TEST_VERIFY (dlclose (handle) == 0);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -39,6 +39,7 @@ extern int   __libc_dlclose (void *__map);
 libc_hidden_proto (__libc_dlopen_mode)
 libc_hidden_proto (__libc_dlsym)
 libc_hidden_proto (__libc_dlclose)
+rtld_hidden_proto (_dl_find_object)
 
 /* Locate shared object containing the given address.  */
 #ifdef ElfW
@@ -46,6 +47,13 @@ extern int _dl_addr (const void *address, Dl_info *info,
 		     struct link_map **mapp, const ElfW(Sym) **symbolp)
      internal_function;
 libc_hidden_proto (_dl_addr)
+
+/* Like _dl_addr, but build the symbol index of the object containing
+   ADDRESS first if it does not have one yet.  This allocates memory,
+   so unlike _dl_addr it is not async-signal-safe.  */
+extern int _dl_addr_index (const void *address, Dl_info *info,
+			   struct link_map **mapp, const ElfW(Sym) **symbolp)
+     internal_function;
 #endif
 
 struct link_map;
@@ -56,6 +64,11 @@ extern void _dl_close (void *map) attribute_hidden;
    provided map arguments.  */
 extern void _dl_close_worker (struct link_map *map, bool force)
     attribute_hidden;
+/* Close the COUNT objects in HANDLES with a single garbage collection
+   pass per namespace, or defer the collection if FLAGS contains
+   DLCLOSE_DEFER.  */
+extern void _dl_close_multiple (void *const *handles, size_t count,
+				int flags) attribute_hidden;
 
 /* Look up NAME in shared object HANDLE (which may be RTLD_DEFAULT or
    RTLD_NEXT).  WHO is the calling function, for RTLD_NEXT.  Returns
@@ -63,6 +76,13 @@ extern void _dl_close_worker (struct link_map *map, bool force)
 extern void *_dl_sym (void *handle, const char *name, void *who)
     internal_function;
 
+/* Return the value of NAME in HANDLE if an earlier _dl_sym call has
+   found it, otherwise NULL.  HANDLE must not be RTLD_DEFAULT or
+   RTLD_NEXT for a cached value to be returned.  Unlike _dl_sym, this
+   can be called without holding GL(dl_load_lock).  */
+extern void *_dl_sym_cached (void *handle, const char *name)
+    internal_function;
+
 /* Look up version VERSION of symbol NAME in shared object HANDLE
    (which may be RTLD_DEFAULT or RTLD_NEXT).  WHO is the calling
    function, for RTLD_NEXT.  Returns the symbol value, which may be
@@ -99,7 +119,8 @@ struct dlfcn_hook
 		  void **extra_info, int flags);
   int (*dlinfo) (void *handle, int request, void *arg, void *dl_caller);
   void *(*dlmopen) (Lmid_t nsid, const char *file, int mode, void *dl_caller);
-  void *pad[4];
+  int (*dlclose_multiple) (void *const *handles, size_t count, int flags);
+  void *pad[3];
 };
 
 extern struct dlfcn_hook *_dlfcn_hook;
@@ -125,6 +146,8 @@ extern int __dladdr1 (const void *address, Dl_info *info,
      attribute_hidden;
 extern int __dlinfo (void *handle, int request, void *arg DL_CALLER_DECL)
      attribute_hidden;
+extern int __dlclose_multiple (void *const *handles, size_t count, int flags)
+     attribute_hidden;
 
 #ifndef SHARED
 struct link_map;
@@ -57,6 +57,7 @@ extern unsigned int la_objopen (struct link_map *__map, Lmid_t __lmid,
 struct libname_list;
 struct r_found_version;
 struct r_search_path_elem;
+struct dl_sym_cache;
 
 /* Forward declaration.  */
 struct link_map;
@@ -202,6 +203,9 @@ struct link_map
     unsigned int l_free_initfini:1; /* Nonzero if l_initfini can be
 				       freed, ie. not allocated with
 				       the dummy malloc in ld.so.  */
+    unsigned int l_find_object_processed:1; /* Nonzero if the object has
+					       been added to the
+					       _dl_find_object index.  */
 
     /* Collected information about own RPATH directories.  */
     struct r_search_path_struct l_rpath_dirs;
@@ -261,6 +265,10 @@ struct link_map
     /* Nonzero if the DSO is used.  */
     unsigned int l_used;
 
+    /* Number of the helper thread which relocated the object at startup,
+       see _dl_relocate_parallel, or zero for the main thread.  */
+    unsigned int l_reloc_helper;
+
     /* Various flag words.  */
     ElfW(Word) l_feature_1;
     ElfW(Word) l_flags_1;
@@ -320,6 +328,35 @@ struct link_map
 
     unsigned long long int l_serial;
 
+    /* Dynamic symbols considered by dladdr, as indices into the symbol
+       table sorted by st_value.  Built on first use by dladdr or dladdr1
+       while holding GL(dl_load_lock), and freed by dlclose.  _dl_addr
+       uses it if present but never builds it.  */
+    Elf32_Word *l_addr_index;
+    Elf32_Word l_addr_index_size;
+    /* For each element of l_addr_index, the largest st_value + st_size
+       of it and all the symbols before it.  Part of the allocation of
+       l_addr_index.  */
+    ElfW(Addr) *l_addr_index_reach;
+
+    /* Results of earlier dlsym calls with this object as the handle,
+       see <dl-sym-cache.h>.  Read without holding any lock.  */
+    struct dl_sym_cache *l_sym_cache;
+
+    /* Statistics for LD_DEBUG=statistics, only collected if it is
+       enabled.  The times are hp_timing_t values.  */
+    struct
+    {
+      unsigned long long int map_time;
+      unsigned long long int relocate_time;
+      unsigned long long int lookup_time;
+      unsigned long long int init_time;
+      /* Number of symbol lookups for references from this object.  */
+      unsigned long int num_lookups;
+      /* Set once the object has been included in a report.  */
+      unsigned int reported:1;
+    } l_stats;
+
     /* Audit information.  This array apparent must be the last in the
        structure.  Never add something after it.  */
     struct auditstate
@@ -589,7 +589,12 @@ shrink_heap (heap_info *h, long diff)
       h->mprotect_size = new_size;
     }
   else
-    __madvise ((char *) h + new_size, diff, MADV_DONTNEED);
+    {
+      /* Discarding the pages also makes them read as zero again, which
+         calloc relies on when the heap grows back.  */
+      if (__madvise ((char *) h + new_size, diff, MADV_DONTNEED) != 0)
+        return -2;
+    }
   /*fprintf(stderr, "shrink %p %08lx\n", h, new_size);*/
 
   h->size = new_size;
@@ -3402,17 +3402,16 @@ __libc_calloc (size_t n, size_t elem_size)
       oldtop = top (av);
       oldtopsize = chunksize (top (av));
 # if MORECORE_CLEARS < 2
-      /* Only newly allocated memory is guaranteed to be cleared.  */
-      if (av == &main_arena &&
+      /* Only newly allocated memory is guaranteed to be cleared.  The
+	 kernel also clears the memory released by systrim when the break
+	 is raised again, but a user-supplied __morecore may not.  */
+      if (av == &main_arena && __morecore != __default_morecore &&
 	  oldtopsize < mp_.sbrk_base + av->max_system_mem - (char *) oldtop)
 	oldtopsize = (mp_.sbrk_base + av->max_system_mem - (char *) oldtop);
 # endif
-      if (av != &main_arena)
-	{
-	  heap_info *heap = heap_for_ptr (oldtop);
-	  if (oldtopsize < (char *) heap + heap->mprotect_size - (char *) oldtop)
-	    oldtopsize = (char *) heap + heap->mprotect_size - (char *) oldtop;
-	}
+      /* The memory past the end of a non-main heap has either never
+	 been used or has been discarded by shrink_heap, so whatever
+	 grow_heap adds to the top chunk is cleared as well.  */
 #endif
     }
   else
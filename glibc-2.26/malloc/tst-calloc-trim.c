@@ -0,0 +1,88 @@
+/* Test that calloc clears memory given back to the system and reused.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+/* Below the mmap threshold, so that the memory comes from the top
+   chunk of the arena.  */
+#define SIZE (96 * 1024)
+
+static void
+check_zero (const unsigned char *p, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+    if (p[i] != 0)
+      FAIL_EXIT1 ("byte %zu of %zu is 0x%x", i, size, p[i]);
+}
+
+/* Dirty memory at the end of the arena, give it back to the top chunk
+   and, if TRIM, to the system, and allocate it again with calloc.  */
+static void
+do_round (bool trim)
+{
+  void *guard = xmalloc (64);
+  for (size_t size = SIZE / 4; size <= SIZE; size *= 2)
+    {
+      unsigned char *p = xmalloc (size);
+      memset (p, 0xff, size);
+      free (p);
+      if (trim)
+	malloc_trim (0);
+      p = calloc (1, size);
+      TEST_VERIFY_EXIT (p != NULL);
+      check_zero (p, size);
+      /* Dirty the memory past the end of the allocation as well.  */
+      unsigned char *q = xmalloc (size);
+      memset (q, 0xff, size);
+      free (q);
+      free (p);
+    }
+  free (guard);
+}
+
+static void *
+thread_func (void *closure)
+{
+  do_round (false);
+  do_round (true);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  /* Keep free from trimming on its own.  */
+  TEST_VERIFY (mallopt (M_TRIM_THRESHOLD, 64 * 1024 * 1024) == 1);
+  TEST_VERIFY (mallopt (M_TOP_PAD, 0) == 1);
+
+  /* The main arena.  */
+  thread_func (NULL);
+
+  /* A thread arena.  */
+  xpthread_join (xpthread_create (NULL, thread_func, NULL));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
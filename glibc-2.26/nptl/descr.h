@@ -34,6 +34,7 @@
 #include <unwind.h>
 #include <bits/types/res_state.h>
 #include <kernel-features.h>
+#include <sys/rseq.h>
 
 #ifndef TCB_ALIGNMENT
 # define TCB_ALIGNMENT	sizeof (double)
@@ -395,6 +396,11 @@ struct pthread
   /* Resolver state.  */
   struct __res_state res;
 
+  /* Restartable sequences area registered with the kernel.  Its cpu_id
+     field always holds the CPU the thread is running on, or a negative
+     value if registration failed.  */
+  struct rseq rseq_area;
+
   /* This member must be last.  */
   char end_padding[];
 
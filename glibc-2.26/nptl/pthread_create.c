@@ -32,6 +32,7 @@
 #include <exit-thread.h>
 #include <default-sched.h>
 #include <futex-internal.h>
+#include <rseq-internal.h>
 #include "libioP.h"
 
 #include <shlib-compat.h>
@@ -410,6 +411,9 @@ START_THREAD_DEFN
     }
 #endif
 
+  /* Register the rseq area if the initial thread could do so.  */
+  rseq_register_current_thread (pd, __rseq_size > 0);
+
 #ifdef SIGCANCEL
   /* If the parent was running cancellation handlers while creating
      the thread the new thread inherited the signal mask.  Reset the
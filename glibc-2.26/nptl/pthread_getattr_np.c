@@ -18,17 +18,91 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
-#include <stdio.h>
-#include <stdio_ext.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/resource.h>
 #include "pthreadP.h"
 #include <lowlevellock.h>
+#include <not-cancel.h>
 #include <ldsodefs.h>
 
 
+/* Locate the line of /proc/self/maps for the mapping which contains
+   ADDR.  Store the end of that mapping in *TOP and the end of the
+   mapping before it, or zero if there is none, in *LAST_TO.  Returns 0
+   on success or an error number.
+
+   pthread_getattr_np is called often by some language runtimes, so the
+   file is read into a buffer on the stack and only the address range at
+   the start of each line is parsed.  Unlike reading it through stdio,
+   this does not allocate any memory.  */
+static int
+find_mapping (uintptr_t addr, uintptr_t *top, uintptr_t *last_to)
+{
+  int fd = open_not_cancel_2 ("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return errno;
+
+  /* Until we found an entry (which should always be the case) mark
+     the result as a failure.  */
+  int ret = ENOENT;
+
+  /* FIELD is 0 while reading the start address of a line, 1 while
+     reading the end address, 2 after the end address and 3 if the line
+     does not start with an address range.  */
+  uintptr_t range[2] = { 0, 0 };
+  unsigned int field = 0;
+  uintptr_t prev_to = 0;
+  char buf[1024];
+  ssize_t n = 0;
+  while (ret == ENOENT
+	 && (n = read_not_cancel (fd, buf, sizeof (buf))) > 0)
+    for (ssize_t i = 0; i < n; ++i)
+      {
+	char c = buf[i];
+	if (c == '\n')
+	  {
+	    if (field == 2)
+	      {
+		if (range[0] <= addr && addr < range[1])
+		  {
+		    /* Found the entry.  Now we have the info we need.  */
+		    *top = range[1];
+		    *last_to = prev_to;
+		    ret = 0;
+		    break;
+		  }
+		prev_to = range[1];
+	      }
+	    range[0] = 0;
+	    range[1] = 0;
+	    field = 0;
+	  }
+	else if (field < 2)
+	  {
+	    if (c >= '0' && c <= '9')
+	      range[field] = range[field] * 16 + (c - '0');
+	    else if (c >= 'a' && c <= 'f')
+	      range[field] = range[field] * 16 + (c - 'a' + 10);
+	    else if (field == 0 && c == '-')
+	      field = 1;
+	    else if (field == 1 && c == ' ')
+	      field = 2;
+	    else
+	      field = 3;
+	  }
+      }
+  if (n < 0)
+    ret = errno;
+
+  close_not_cancel_no_status (fd);
+
+  return ret;
+}
+
+
 int
 pthread_getattr_np (pthread_t thread_id, pthread_attr_t *attr)
 {
@@ -75,87 +149,46 @@ pthread_getattr_np (pthread_t thread_id, pthread_attr_t *attr)
       /* The safest way to get the top of the stack is to read
 	 /proc/self/maps and locate the line into which
 	 __libc_stack_end falls.  */
-      FILE *fp = fopen ("/proc/self/maps", "rce");
-      if (fp == NULL)
-	ret = errno;
+      uintptr_t to;
+      uintptr_t last_to;
+      ret = find_mapping ((uintptr_t) __libc_stack_end, &to, &last_to);
       /* We need the limit of the stack in any case.  */
-      else
-	{
-	  if (getrlimit (RLIMIT_STACK, &rl) != 0)
-	    ret = errno;
-	  else
-	    {
-	      /* We consider the main process stack to have ended with
-	         the page containing __libc_stack_end.  There is stuff below
-		 it in the stack too, like the program arguments, environment
-		 variables and auxv info, but we ignore those pages when
-		 returning size so that the output is consistent when the
-		 stack is marked executable due to a loaded DSO requiring
-		 it.  */
-	      void *stack_end = (void *) ((uintptr_t) __libc_stack_end
-					  & -(uintptr_t) GLRO(dl_pagesize));
-#if _STACK_GROWS_DOWN
-	      stack_end += GLRO(dl_pagesize);
-#endif
-	      /* We need no locking.  */
-	      __fsetlocking (fp, FSETLOCKING_BYCALLER);
-
-	      /* Until we found an entry (which should always be the case)
-		 mark the result as a failure.  */
-	      ret = ENOENT;
+      if (ret == 0 && getrlimit (RLIMIT_STACK, &rl) != 0)
+	ret = errno;
 
-	      char *line = NULL;
-	      size_t linelen = 0;
+      if (ret == 0)
+	{
+	  /* We consider the main process stack to have ended with
+	     the page containing __libc_stack_end.  There is stuff below
+	     it in the stack too, like the program arguments, environment
+	     variables and auxv info, but we ignore those pages when
+	     returning size so that the output is consistent when the
+	     stack is marked executable due to a loaded DSO requiring
+	     it.  */
+	  void *stack_end = (void *) ((uintptr_t) __libc_stack_end
+				      & -(uintptr_t) GLRO(dl_pagesize));
 #if _STACK_GROWS_DOWN
-	      uintptr_t last_to = 0;
+	  stack_end += GLRO(dl_pagesize);
 #endif
-
-	      while (! feof_unlocked (fp))
-		{
-		  if (__getdelim (&line, &linelen, '\n', fp) <= 0)
-		    break;
-
-		  uintptr_t from;
-		  uintptr_t to;
-		  if (sscanf (line, "%" SCNxPTR "-%" SCNxPTR, &from, &to) != 2)
-		    continue;
-		  if (from <= (uintptr_t) __libc_stack_end
-		      && (uintptr_t) __libc_stack_end < to)
-		    {
-		      /* Found the entry.  Now we have the info we need.  */
-		      iattr->stackaddr = stack_end;
-		      iattr->stacksize =
-		        rl.rlim_cur - (size_t) (to - (uintptr_t) stack_end);
-
-		      /* Cut it down to align it to page size since otherwise we
-		         risk going beyond rlimit when the kernel rounds up the
-		         stack extension request.  */
-		      iattr->stacksize = (iattr->stacksize
-					  & -(intptr_t) GLRO(dl_pagesize));
+	  iattr->stackaddr = stack_end;
+	  iattr->stacksize = rl.rlim_cur - (size_t) (to - (uintptr_t) stack_end);
+
+	  /* Cut it down to align it to page size since otherwise we
+	     risk going beyond rlimit when the kernel rounds up the
+	     stack extension request.  */
+	  iattr->stacksize = (iattr->stacksize
+			      & -(intptr_t) GLRO(dl_pagesize));
 #if _STACK_GROWS_DOWN
-		      /* The limit might be too high.  */
-		      if ((size_t) iattr->stacksize
-			  > (size_t) iattr->stackaddr - last_to)
-			iattr->stacksize = (size_t) iattr->stackaddr - last_to;
+	  /* The limit might be too high.  */
+	  if ((size_t) iattr->stacksize
+	      > (size_t) iattr->stackaddr - last_to)
+	    iattr->stacksize = (size_t) iattr->stackaddr - last_to;
 #else
-		      /* The limit might be too high.  */
-		      if ((size_t) iattr->stacksize
-			  > to - (size_t) iattr->stackaddr)
-			iattr->stacksize = to - (size_t) iattr->stackaddr;
-#endif
-		      /* We succeed and no need to look further.  */
-		      ret = 0;
-		      break;
-		    }
-#if _STACK_GROWS_DOWN
-		  last_to = to;
+	  /* The limit might be too high.  */
+	  if ((size_t) iattr->stacksize
+	      > to - (size_t) iattr->stackaddr)
+	    iattr->stacksize = to - (size_t) iattr->stackaddr;
 #endif
-		}
-
-	      free (line);
-	    }
-
-	  fclose (fp);
 	}
     }
 
@@ -28,56 +28,85 @@
 #include <shlib-compat.h>
 
 
-/* See sem_wait for an explanation of the algorithm.  */
-int
-__new_sem_post (sem_t *sem)
+/* Add N tokens to the semaphore and wake up to N potentially blocked
+   waiters with a single futex_wake call.  N must not be zero.  See sem_wait
+   for an explanation of the algorithm.  */
+static __always_inline int
+__sem_post_n (struct new_sem *isem, unsigned int n)
 {
-  struct new_sem *isem = (struct new_sem *) sem;
   int private = isem->private;
 
 #if __HAVE_64B_ATOMICS
-  /* Add a token to the semaphore.  We use release MO to make sure that a
-     thread acquiring this token synchronizes with us and other threads that
-     added tokens before (the release sequence includes atomic RMW operations
-     by other threads).  */
+  /* Add the tokens to the semaphore.  We use release MO to make sure that a
+     thread acquiring one of these tokens synchronizes with us and other
+     threads that added tokens before (the release sequence includes atomic
+     RMW operations by other threads).  */
   /* TODO Use atomic_fetch_add to make it scale better than a CAS loop?  */
   uint64_t d = atomic_load_relaxed (&isem->data);
   do
     {
-      if ((d & SEM_VALUE_MASK) == SEM_VALUE_MAX)
+      if (SEM_VALUE_MAX - (d & SEM_VALUE_MASK) < n)
 	{
 	  __set_errno (EOVERFLOW);
 	  return -1;
 	}
     }
-  while (!atomic_compare_exchange_weak_release (&isem->data, &d, d + 1));
+  while (!atomic_compare_exchange_weak_release (&isem->data, &d, d + n));
 
-  /* If there is any potentially blocked waiter, wake one of them.  */
-  if ((d >> SEM_NWAITERS_SHIFT) > 0)
-    futex_wake (((unsigned int *) &isem->data) + SEM_VALUE_OFFSET, 1, private);
+  /* If there is any potentially blocked waiter, wake as many of them as
+     there are new tokens.  nwaiters is an upper bound on the number of
+     blocked waiters, so there is no point in waking more than that.  */
+  uint64_t nwaiters = d >> SEM_NWAITERS_SHIFT;
+  if (nwaiters > 0)
+    futex_wake (((unsigned int *) &isem->data) + SEM_VALUE_OFFSET,
+		nwaiters < n ? (int) nwaiters : (int) n, private);
 #else
-  /* Add a token to the semaphore.  Similar to 64b version.  */
+  /* Add the tokens to the semaphore.  Similar to 64b version.  */
   unsigned int v = atomic_load_relaxed (&isem->value);
   do
     {
-      if ((v >> SEM_VALUE_SHIFT) == SEM_VALUE_MAX)
+      if (SEM_VALUE_MAX - (v >> SEM_VALUE_SHIFT) < n)
 	{
 	  __set_errno (EOVERFLOW);
 	  return -1;
 	}
     }
   while (!atomic_compare_exchange_weak_release
-	 (&isem->value, &v, v + (1 << SEM_VALUE_SHIFT)));
+	 (&isem->value, &v, v + (n << SEM_VALUE_SHIFT)));
 
-  /* If there is any potentially blocked waiter, wake one of them.  */
+  /* If there is any potentially blocked waiter, wake up to N of them.  We
+     only know whether there are waiters, not how many.  */
   if ((v & SEM_NWAITERS_MASK) != 0)
-    futex_wake (&isem->value, 1, private);
+    futex_wake (&isem->value, (int) n, private);
 #endif
 
   return 0;
 }
+
+int
+__new_sem_post (sem_t *sem)
+{
+  return __sem_post_n ((struct new_sem *) sem, 1);
+}
 versioned_symbol (libpthread, __new_sem_post, sem_post, GLIBC_2_1);
 
+/* Post N tokens to SEM at once.  This is equivalent to N calls to sem_post
+   but uses a single atomic read-modify-write operation and at most one
+   futex_wake call.  */
+int
+__sem_post_multiple (sem_t *sem, unsigned int n)
+{
+  if (n == 0)
+    return 0;
+  if (n > SEM_VALUE_MAX)
+    {
+      __set_errno (EINVAL);
+      return -1;
+    }
+  return __sem_post_n ((struct new_sem *) sem, n);
+}
+weak_alias (__sem_post_multiple, sem_post_multiple)
+
 
 #if SHLIB_COMPAT (libpthread, GLIBC_2_0, GLIBC_2_1)
 int
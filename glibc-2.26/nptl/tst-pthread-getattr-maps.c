@@ -0,0 +1,161 @@
+/* Check pthread_getattr_np for the initial thread against /proc/self/maps.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/xstdio.h>
+#include <support/xunistd.h>
+
+/* Extent of the mapping containing the stack, and the end of the
+   mapping right below it.  */
+struct stack_vma
+{
+  uintptr_t from;
+  uintptr_t to;
+  uintptr_t prev_to;
+};
+
+static void
+find_stack_vma (uintptr_t sp, struct stack_vma *vma)
+{
+  FILE *fp = xfopen ("/proc/self/maps", "r");
+  char *line = NULL;
+  size_t linelen = 0;
+  uintptr_t last_to = 0;
+  bool found = false;
+
+  while (getline (&line, &linelen, fp) > 0)
+    {
+      uintptr_t from;
+      uintptr_t to;
+      if (sscanf (line, "%" SCNxPTR "-%" SCNxPTR, &from, &to) != 2)
+	continue;
+      if (from <= sp && sp < to)
+	{
+	  vma->from = from;
+	  vma->to = to;
+	  vma->prev_to = last_to;
+	  found = true;
+	  break;
+	}
+      last_to = to;
+    }
+
+  free (line);
+  xfclose (fp);
+  if (!found)
+    FAIL_EXIT1 ("no mapping in /proc/self/maps contains %#" PRIxPTR, sp);
+}
+
+/* Compare the attributes of the initial thread against the current
+   layout of the address space.  Returns the lowest address reported as
+   part of the stack.  */
+static uintptr_t
+check_stack (void)
+{
+  volatile char marker = 0;
+  uintptr_t sp = (uintptr_t) &marker;
+
+  pthread_attr_t attr;
+  int ret = pthread_getattr_np (pthread_self (), &attr);
+  if (ret != 0)
+    FAIL_EXIT1 ("pthread_getattr_np: %m (%d)", ret);
+  void *stackaddr;
+  size_t stacksize;
+  ret = pthread_attr_getstack (&attr, &stackaddr, &stacksize);
+  if (ret != 0)
+    FAIL_EXIT1 ("pthread_attr_getstack: %d", ret);
+  pthread_attr_destroy (&attr);
+
+  /* pthread_attr_getstack reports the lowest address.  */
+  uintptr_t bottom = (uintptr_t) stackaddr;
+  uintptr_t top = bottom + stacksize;
+
+  struct stack_vma vma;
+  find_stack_vma (sp, &vma);
+  printf ("info: stack %#" PRIxPTR "-%#" PRIxPTR ", mapping %#" PRIxPTR
+	  "-%#" PRIxPTR ", previous mapping ends at %#" PRIxPTR "\n",
+	  bottom, top, vma.from, vma.to, vma.prev_to);
+
+  TEST_VERIFY (sp < top);
+  TEST_VERIFY (top <= vma.to);
+  TEST_VERIFY (bottom <= vma.from);
+  TEST_VERIFY (bottom >= vma.prev_to);
+  return bottom;
+}
+
+static int
+do_test (void)
+{
+  /* Make sure there is a finite limit, so that the reported size is
+     derived from it rather than from the gap alone.  */
+  struct rlimit rl;
+  if (getrlimit (RLIMIT_STACK, &rl) != 0)
+    FAIL_EXIT1 ("getrlimit: %m");
+  if (rl.rlim_cur == RLIM_INFINITY || rl.rlim_cur > 8 * 1024 * 1024)
+    {
+      rl.rlim_cur = 8 * 1024 * 1024;
+      if (setrlimit (RLIMIT_STACK, &rl) != 0)
+	FAIL_EXIT1 ("setrlimit: %m");
+    }
+
+  uintptr_t bottom = check_stack ();
+
+  /* Place a mapping inside the range the stack limit would allow, but
+     outside the kernel's stack guard gap.  The reported stack must now
+     end above it.  */
+  volatile char marker = 0;
+  struct stack_vma vma;
+  find_stack_vma ((uintptr_t) &marker, &vma);
+  long int pagesize = sysconf (_SC_PAGESIZE);
+  size_t length = 16 * pagesize;
+  uintptr_t hint = vma.from - 2 * 1024 * 1024 - length;
+  if (hint < bottom || hint < vma.prev_to)
+    {
+      puts ("info: no room below the stack, skipping mapping check");
+      return 0;
+    }
+  void *p = mmap ((void *) hint, length, PROT_NONE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    FAIL_EXIT1 ("mmap: %m");
+  if ((uintptr_t) p != hint)
+    {
+      printf ("info: mapping placed at %p instead of %#" PRIxPTR
+	      ", skipping mapping check\n", p, hint);
+      xmunmap (p, length);
+      return 0;
+    }
+
+  bottom = check_stack ();
+  TEST_VERIFY (bottom >= hint + length);
+
+  xmunmap (p, length);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,91 @@
+/* Test sem_post_multiple.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+#define NTHREADS 8
+
+static sem_t sem;
+
+static int
+getvalue (void)
+{
+  int val;
+  TEST_VERIFY_EXIT (sem_getvalue (&sem, &val) == 0);
+  return val;
+}
+
+static void *
+tf (void *arg)
+{
+  TEST_VERIFY (sem_wait (&sem) == 0);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  TEST_VERIFY_EXIT (sem_init (&sem, 0, 0) == 0);
+
+  /* A zero count does nothing.  */
+  TEST_VERIFY (sem_post_multiple (&sem, 0) == 0);
+  TEST_VERIFY (getvalue () == 0);
+
+  /* Tokens posted at once can be consumed one by one.  */
+  TEST_VERIFY (sem_post_multiple (&sem, 5) == 0);
+  TEST_VERIFY (getvalue () == 5);
+  for (int i = 0; i < 5; ++i)
+    TEST_VERIFY (sem_trywait (&sem) == 0);
+  errno = 0;
+  TEST_VERIFY (sem_trywait (&sem) == -1);
+  TEST_VERIFY (errno == EAGAIN);
+
+  /* Wake several blocked waiters with a single post.  */
+  pthread_t th[NTHREADS];
+  for (int i = 0; i < NTHREADS; ++i)
+    th[i] = xpthread_create (NULL, tf, NULL);
+  TEST_VERIFY (sem_post_multiple (&sem, NTHREADS) == 0);
+  for (int i = 0; i < NTHREADS; ++i)
+    xpthread_join (th[i]);
+  TEST_VERIFY (getvalue () == 0);
+  TEST_VERIFY_EXIT (sem_destroy (&sem) == 0);
+
+  /* The value must not be changed on overflow.  */
+  TEST_VERIFY_EXIT (sem_init (&sem, 0, SEM_VALUE_MAX - 1) == 0);
+  errno = 0;
+  TEST_VERIFY (sem_post_multiple (&sem, 2) == -1);
+  TEST_VERIFY (errno == EOVERFLOW);
+  TEST_VERIFY (getvalue () == SEM_VALUE_MAX - 1);
+  TEST_VERIFY (sem_post_multiple (&sem, 1) == 0);
+  TEST_VERIFY (getvalue () == SEM_VALUE_MAX);
+
+  /* Counts that can never be represented are rejected.  */
+  errno = 0;
+  TEST_VERIFY (sem_post_multiple (&sem, (unsigned int) SEM_VALUE_MAX + 1)
+	       == -1);
+  TEST_VERIFY (errno == EINVAL);
+  TEST_VERIFY_EXIT (sem_destroy (&sem) == 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -63,6 +63,14 @@ extern void *memset (void *__s, int __c, size_t __n) __THROW __nonnull ((1));
 extern int memcmp (const void *__s1, const void *__s2, size_t __n)
      __THROW __attribute_pure__ __nonnull ((1, 2));
 
+/* Compare N bytes of S1 and S2.  Return zero if they are equal and a
+   nonzero value otherwise.  Unlike for memcmp, the sign of a nonzero
+   result has no meaning, so memcmp is a correct implementation but
+   this may be faster.  Compilers may use it for memcmp calls whose
+   result is only compared with zero.  */
+extern int __memcmpeq (const void *__s1, const void *__s2, size_t __n)
+     __THROW __attribute_pure__ __nonnull ((1, 2));
+
 /* Search N bytes of S for C.  */
 #ifdef __CORRECT_ISO_CPP_STRING_H_PROTO
 extern "C++"
@@ -20,8 +20,12 @@
 #undef __strsep
 #undef strsep
 
+#ifndef STRSEP
+# define STRSEP __strsep
+#endif
+
 char *
-__strsep (char **stringp, const char *delim)
+STRSEP (char **stringp, const char *delim)
 {
   char *begin, *end;
 
@@ -44,6 +48,8 @@ __strsep (char **stringp, const char *delim)
 
   return begin;
 }
+#ifndef NO_ALIAS
 weak_alias (__strsep, strsep)
 strong_alias (__strsep, __strsep_g)
 libc_hidden_def (__strsep_g)
+#endif
@@ -28,6 +28,10 @@
 # define __strtok_r strtok_r
 #endif
 
+#ifndef STRTOK_R
+# define STRTOK_R __strtok_r
+#endif
+
 /* Parse S into tokens separated by characters in DELIM.
    If S is NULL, the saved pointer in SAVE_PTR is used as
    the next starting point.  For example:
@@ -39,7 +43,7 @@
 		// s = "abc\0-def\0"
 */
 char *
-__strtok_r (char *s, const char *delim, char **save_ptr)
+STRTOK_R (char *s, const char *delim, char **save_ptr)
 {
   char *end;
 
@@ -73,7 +77,7 @@ __strtok_r (char *s, const char *delim, char **save_ptr)
   *save_ptr = end + 1;
   return s;
 }
-#ifdef weak_alias
+#if defined weak_alias && !defined NO_ALIAS
 libc_hidden_def (__strtok_r)
 weak_alias (__strtok_r, strtok_r)
 #endif
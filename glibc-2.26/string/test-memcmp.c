@@ -21,6 +21,8 @@
 #define TEST_MAIN
 #ifdef WIDE
 # define TEST_NAME "wmemcmp"
+#elif defined TEST_MEMCMPEQ
+# define TEST_NAME "__memcmpeq"
 #else
 # define TEST_NAME "memcmp"
 #endif
@@ -51,7 +53,11 @@ simple_wmemcmp (const wchar_t *s1, const wchar_t *s2, size_t n)
 #else
 # include <limits.h>
 
-# define MEMCMP memcmp
+# ifdef TEST_MEMCMPEQ
+#  define MEMCMP __memcmpeq
+# else
+#  define MEMCMP memcmp
+# endif
 # define MEMCPY memcpy
 # define SIMPLE_MEMCMP simple_memcmp
 # define CHAR char
@@ -71,6 +77,17 @@ simple_memcmp (const char *s1, const char *s2, size_t n)
 }
 #endif
 
+/* Whether RESULT is wrong if EXPEC is the expected result.  Only the
+   sign matters, or for __memcmpeq only whether it is zero.  */
+#ifdef TEST_MEMCMPEQ
+# define BAD_RESULT(result, expec) (((result) == 0) != ((expec) == 0))
+#else
+# define BAD_RESULT(result, expec) \
+  (((expec) == 0 && (result) != 0)				\
+   || ((expec) < 0 && (result) >= 0)				\
+   || ((expec) > 0 && (result) <= 0))
+#endif
+
 typedef int (*proto_t) (const CHAR *, const CHAR *, size_t);
 
 IMPL (SIMPLE_MEMCMP, 0)
@@ -81,9 +98,7 @@ check_result (impl_t *impl, const CHAR *s1, const CHAR *s2, size_t len,
 	      int exp_result)
 {
   int result = CALL (impl, s1, s2, len);
-  if ((exp_result == 0 && result != 0)
-      || (exp_result < 0 && result >= 0)
-      || (exp_result > 0 && result <= 0))
+  if (BAD_RESULT (result, exp_result))
     {
       error (0, 0, "Wrong result in function %s %d %d", impl->name,
 	     result, exp_result);
@@ -188,9 +203,7 @@ do_random_tests (void)
 	{
 	  r = CALL (impl, (CHAR *) p1 + align1, (const CHAR *) p2 + align2,
 		    len);
-	  if ((r == 0 && result)
-	      || (r < 0 && result >= 0)
-	      || (r > 0 && result <= 0))
+	  if (BAD_RESULT (r, result))
 	    {
 	      error (0, 0, "Iteration %zd - wrong result in function %s (%zd, %zd, %zd, %zd) %ld != %d, p1 %p p2 %p",
 		     n, impl->name, align1 * CHARBYTES & 63,  align2 * CHARBYTES & 63, len, pos, r, result, p1, p2);
@@ -16,6 +16,7 @@
    License along with the GNU C Library; if not, see
    <http://www.gnu.org/licenses/>.  */
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifndef _DL_CACHE_DEFAULT_ID
@@ -89,12 +90,37 @@ struct cache_file_new
   char version[sizeof CACHE_VERSION - 1];
   uint32_t nlibs;		/* Number of entries.  */
   uint32_t len_strings;		/* Size of string table. */
-  uint32_t unused[5];		/* Leave space for future extensions
+  uint32_t hash_offset;		/* Offset of the hash table, see below,
+				   or 0 if there is none.  */
+  uint32_t unused[4];		/* Leave space for future extensions
 				   and align to 8 byte boundary.  */
   struct file_entry_new libs[0]; /* Entries describing libraries.  */
   /* After this the string table of size len_strings is found.	*/
 };
 
+/* The hash table maps library names to the range of entries in
+   cache_file_new.libs with that name, so that the dynamic linker does
+   not have to search the sorted entries.  Older dynamic linkers ignore
+   it.  Like the string indices, HASH_OFFSET is relative to the start of
+   struct cache_file_new.  The table uses open addressing with linear
+   probing and always has at least one empty slot.  */
+#define CACHE_HASH_MAGIC 0x48534331	/* "1CSH" in little endian.  */
+
+struct cache_hash_slot
+{
+  uint32_t hash;		/* _dl_cache_hash of the library name.  */
+  uint32_t first;		/* Index of the first entry with this name
+				   plus 1, or 0 for an empty slot.  */
+  uint32_t count;		/* Number of entries with this name.  */
+};
+
+struct cache_hash_table
+{
+  uint32_t magic;		/* CACHE_HASH_MAGIC.  */
+  uint32_t nslots;		/* Number of slots, a power of two.  */
+  struct cache_hash_slot slots[0];
+};
+
 /* Used to align cache_file_new.  */
 #define ALIGN_CACHE(addr)				\
 (((addr) + __alignof__ (struct cache_file_new) -1)	\
@@ -102,3 +128,80 @@ struct cache_file_new
 
 extern int _dl_cache_libcmp (const char *p1, const char *p2)
      internal_function attribute_hidden;
+
+/* Hash function for the cache hash table.  Names which are equal
+   according to _dl_cache_libcmp, which compares sequences of digits by
+   their numeric value, have the same hash, so leading zeros are
+   skipped.  */
+static inline uint32_t
+_dl_cache_hash (const char *name)
+{
+  uint32_t hash = 2166136261u;
+  unsigned char prev = '\0';
+  while (*name != '\0')
+    {
+      unsigned char c = *name++;
+      if (c == '0' && !(prev >= '0' && prev <= '9'))
+	/* Keep the last zero of a number which is zero.  */
+	while (c == '0' && *name >= '0' && *name <= '9')
+	  c = *name++;
+      hash = (hash ^ c) * 16777619u;
+      prev = c;
+    }
+  return hash;
+}
+
+/* Return the hash table of the new format cache CACHE, which extends
+   over SIZE bytes, or NULL if it has none or the table is invalid.  */
+static inline const struct cache_hash_table *
+_dl_cache_hash_table (const struct cache_file_new *cache, size_t size)
+{
+  uint32_t offset = cache->hash_offset;
+  if (offset == 0
+      || offset % __alignof__ (struct cache_hash_table) != 0
+      || offset > size
+      || size - offset < sizeof (struct cache_hash_table))
+    return NULL;
+
+  const struct cache_hash_table *table
+    = (const void *) ((const char *) cache + offset);
+  if (table->magic != CACHE_HASH_MAGIC
+      || table->nslots == 0
+      || (table->nslots & (table->nslots - 1)) != 0
+      || ((size - offset - sizeof (struct cache_hash_table))
+	  / sizeof (struct cache_hash_slot)) < table->nslots)
+    return NULL;
+  return table;
+}
+
+/* Return the slot of TABLE, the hash table of the new format cache
+   CACHE of SIZE bytes, for NAME, or NULL if NAME is not in the
+   cache.  */
+static inline const struct cache_hash_slot *
+_dl_cache_hash_lookup (const struct cache_file_new *cache, size_t size,
+		       const struct cache_hash_table *table, const char *name)
+{
+  uint32_t hash = _dl_cache_hash (name);
+  uint32_t mask = table->nslots - 1;
+  uint32_t i = hash & mask;
+
+  /* The table always contains an empty slot, but do not rely on this in
+     case the file is corrupted.  */
+  for (uint32_t probes = 0; probes <= mask; ++probes)
+    {
+      const struct cache_hash_slot *slot = &table->slots[i];
+      if (slot->first == 0)
+	break;
+      if (slot->hash == hash
+	  && slot->first <= cache->nlibs
+	  && slot->count <= cache->nlibs - (slot->first - 1))
+	{
+	  uint32_t key = cache->libs[slot->first - 1].key;
+	  if (key < size
+	      && _dl_cache_libcmp (name, (const char *) cache + key) == 0)
+	    return slot;
+	}
+      i = (i + 1) & mask;
+    }
+  return NULL;
+}
@@ -88,6 +88,11 @@ typedef struct link_map *lookup_t;
        || (ADDR) < (L)->l_addr + (SYM)->st_value + (SYM)->st_size)	\
    && ((MATCHSYM) == NULL || (MATCHSYM)->st_value < (SYM)->st_value))
 
+/* Nonzero if DL_ADDR_SYM_MATCH only matches symbols whose st_value is
+   at most the address and at least the address minus st_size, so that
+   dladdr can use an index sorted by st_value.  */
+#define DL_ADDR_SYM_INDEX 1
+
 /* According to the ELF gABI no STV_HIDDEN or STV_INTERNAL symbols are
    expected to be present in dynamic symbol tables as they should have
    been either removed or converted to STB_LOCAL binding by the static
@@ -405,12 +410,21 @@ struct rtld_global
   EXTERN size_t _dl_tls_static_used;
   /* Alignment requirement of the static TLS block.  */
   EXTERN size_t _dl_tls_static_align;
+  /* Part of the static TLS surplus which is used for the TLS blocks of
+     dlopen'ed modules even if they do not require static TLS, as set
+     by the glibc.rtld.optional_static_tls tunable.  */
+  EXTERN size_t _dl_tls_static_optional;
 
 /* Number of additional entries in the slotinfo array of each slotinfo
    list element.  A large number makes it almost certain take we never
    have to iterate beyond the first element in the slotinfo list.  */
 #define TLS_SLOTINFO_SURPLUS (62)
 
+/* Amount of excess space in the static TLS area which is kept free
+   for dynamically loaded modules defining IE-model TLS data.  The
+   optional surplus is allocated in addition to this.  */
+#define TLS_STATIC_SURPLUS	(64 + DL_NNS * 100)
+
 /* Number of additional slots in the dtv allocated.  */
 #define DTV_SURPLUS	(14)
 
@@ -475,6 +489,8 @@ struct rtld_global_ro
 /* These two are used only internally.  */
 #define DL_DEBUG_HELP       (1 << 10)
 #define DL_DEBUG_PRELINK    (1 << 11)
+/* Print the statistics in JSON format.  */
+#define DL_DEBUG_JSON       (1 << 12)
 
   /* OS version.  */
   EXTERN unsigned int _dl_osversion;
@@ -597,6 +613,7 @@ struct rtld_global_ro
   void *(*_dl_open) (const char *file, int mode, const void *caller_dlopen,
 		     Lmid_t nsid, int argc, char *argv[], char *env[]);
   void (*_dl_close) (void *map);
+  void (*_dl_close_multiple) (void *const *handles, size_t count, int flags);
   void *(*_dl_tls_get_addr_soft) (struct link_map *);
 #ifdef HAVE_DL_DISCOVER_OSVERSION
   int (*_dl_discover_osversion) (void);
@@ -687,6 +704,41 @@ extern int _dl_sysdep_open_zero_fill (void); /* dl-sysdep.c */
 extern void _dl_debug_printf (const char *fmt, ...)
      __attribute__ ((__format__ (__printf__, 1, 2))) attribute_hidden;
 
+/* Events for which _dl_statistics_report prints statistics.  */
+enum dl_statistics_event
+  {
+    /* The initially loaded objects have been relocated.  */
+    dl_statistics_startup,
+    /* The constructors of the initially loaded objects have run.  */
+    dl_statistics_init,
+    /* A dlopen call has completed.  */
+    dl_statistics_dlopen
+  };
+
+/* Totals for a statistics report.  The times are hp_timing_t values,
+   or zero if they are not known.  */
+struct dl_statistics
+{
+  enum dl_statistics_event event;
+  /* The name passed to dlopen, or NULL.  */
+  const char *file;
+  Lmid_t nsid;
+  unsigned long long int total_time;
+  unsigned long long int relocate_time;
+  unsigned long long int load_time;
+  unsigned long int num_relocations;
+  unsigned long int num_cache_relocations;
+  unsigned long int num_relative_relocations;
+};
+
+/* Print the per-object statistics for EVENT on the debug file
+   descriptor, together with the totals in JSON mode.  For the startup
+   and dlopen events, the objects in namespace NSID which have not been
+   reported before are included, for the init event all objects in the
+   base namespace whose constructors have been timed.  */
+extern void _dl_statistics_report (const struct dl_statistics *stats)
+     attribute_hidden;
+
 /* Write message on the debug file descriptor.  The parameters are
    interpreted as for a `printf' call.  All the lines buf the first
    start with a tag showing the PID.  */
@@ -846,6 +898,22 @@ extern lookup_t _dl_lookup_symbol_x (const char *undef,
 				     struct link_map *skip_map)
      internal_function attribute_hidden;
 
+/* Memoize the results of lookups in the global scope of MAIN_MAP until
+   _dl_lookup_memo_end is called.  Used while the initially loaded
+   objects are relocated, when the global scope cannot change.  */
+extern void _dl_lookup_memo_start (struct link_map *main_map)
+     attribute_hidden;
+
+/* Discard the memoized lookup results.  Must not be called while other
+   threads can perform lookups.  */
+extern void _dl_lookup_memo_end (void) attribute_hidden;
+
+/* Stop using the memoized lookup results, for example because the
+   global scope is about to change.  Other threads may still be in the
+   middle of a lookup, so the memory is only freed by
+   _dl_lookup_memo_end.  */
+extern void _dl_lookup_memo_disable (void) attribute_hidden;
+
 
 /* Look up symbol NAME in MAP's scope and return its run-time address.  */
 extern ElfW(Addr) _dl_symbol_value (struct link_map *map, const char *name)
@@ -869,6 +937,15 @@ extern void _dl_relocate_object (struct link_map *map,
 				 int reloc_mode, int consider_profiling)
      attribute_hidden;
 
+/* Relocate the objects loaded at startup on helper threads if this has
+   been enabled with the glibc.rtld.relocation_threads tunable.
+   RELOC_MODE is passed to _dl_relocate_object.  The dynamic linker
+   itself is not relocated.  The caller must still relocate the objects
+   in MAIN_MAP->l_initfini sequentially afterwards; those processed here
+   are already marked as relocated.  */
+extern void _dl_relocate_parallel (struct link_map *main_map, int reloc_mode)
+     attribute_hidden;
+
 /* Protect PT_GNU_RELRO area.  */
 extern void _dl_protect_relro (struct link_map *map)
      internal_function attribute_hidden;
@@ -933,6 +1010,46 @@ extern void _dl_init_paths (const char *library_path)
    the timers.  */
 extern void _dl_start_profile (void) internal_function attribute_hidden;
 
+/* The histogram in the profiling data file of an object, as mapped by
+   _dl_profile_open.  */
+struct dl_profile_hist
+{
+  /* The mapping of the whole file.  */
+  void *addr;
+  size_t size;
+  /* The run-time address and size of the text covered by KCOUNT.  */
+  uintptr_t lowpc;
+  size_t textsize;
+  /* One counter for every HISTFRACTION * sizeof (HISTCOUNTER) bytes of
+     text.  */
+  uint16_t *kcount;
+};
+
+/* Create or open the profiling data file NAME.profile for MAP in the
+   profiling output directory and map it into *RESULT.  With ARCS, the
+   file has room for the call graph arcs recorded by LD_PROFILE,
+   otherwise it only contains the histogram.  Return false, after
+   printing a message, if this fails.  */
+extern bool _dl_profile_open (struct link_map *map, const char *name,
+			      bool arcs, struct dl_profile_hist *result)
+     internal_function attribute_hidden;
+
+/* Nonzero if the sampling profiler requested by the
+   glibc.rtld.profile_sample tunable is running.  */
+extern int _dl_profile_sampling attribute_hidden;
+
+/* Start the sampling profiler if it is requested, for the objects
+   which have been loaded at startup.  */
+extern void _dl_profile_sample_start (void) attribute_hidden;
+
+/* Sample the object MAP, which has just been loaded by dlopen, if it
+   is selected for profiling.  */
+extern void _dl_profile_sample_add (struct link_map *map) attribute_hidden;
+
+/* Stop sampling the object MAP, which is about to be unloaded.  */
+extern void _dl_profile_sample_remove (struct link_map *map)
+     attribute_hidden;
+
 /* The actual functions used to keep book on the calls.  */
 extern void _dl_mcount (ElfW(Addr) frompc, ElfW(Addr) selfpc);
 rtld_hidden_proto (_dl_mcount)
@@ -969,6 +1086,10 @@ extern char *_dl_load_cache_lookup (const char *name)
    once needed.  */
 extern void _dl_unload_cache (void) attribute_hidden;
 
+/* Like _dl_unload_cache, but keep the file mapped if it is unchanged
+   when it is needed again.  */
+extern void _dl_release_cache (void) attribute_hidden;
+
 /* System-dependent function to read a file's whole contents in the
    most convenient manner available.  *SIZEP gets the size of the
    file.  On error MAP_FAILED is returned.  */
@@ -1022,6 +1143,12 @@ extern void _dl_get_tls_static_info (size_t *sizep, size_t *alignp)
 extern void _dl_allocate_static_tls (struct link_map *map)
      internal_function attribute_hidden;
 
+/* Try to place the TLS block of MAP, which is being loaded by dlopen,
+   into the optional part of the static TLS surplus.  Return 0 on
+   success and -1 if the block does not fit.  */
+extern int _dl_try_allocate_optional_static_tls (struct link_map *map)
+     internal_function attribute_hidden;
+
 /* These are internal entry points to the two halves of _dl_allocate_tls,
    only used within rtld.c itself at startup time.  */
 extern void *_dl_allocate_tls_storage (void)
@@ -67,6 +67,11 @@ extern int sem_trywait (sem_t *__sem) __THROWNL;
 /* Post SEM.  */
 extern int sem_post (sem_t *__sem) __THROWNL;
 
+#ifdef __USE_GNU
+/* Post SEM COUNT times, waking up to COUNT waiters at once.  */
+extern int sem_post_multiple (sem_t *__sem, unsigned int __count) __THROWNL;
+#endif
+
 /* Get current value of SEM and store it in *SVAL.  */
 extern int sem_getvalue (sem_t *__restrict __sem, int *__restrict __sval)
      __THROW;
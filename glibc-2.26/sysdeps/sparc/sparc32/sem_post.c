@@ -28,35 +28,55 @@
 #include <shlib-compat.h>
 
 
-/* See sem_wait for an explanation of the algorithm.  */
-int
-__new_sem_post (sem_t *sem)
+/* Add N tokens to the semaphore and wake up to N waiters.  N must not be
+   zero.  See sem_wait for an explanation of the algorithm.  */
+static int
+__sem_post_n (struct new_sem *isem, unsigned int n)
 {
-  struct new_sem *isem = (struct new_sem *) sem;
   int private = isem->private;
   unsigned int v;
 
   __sparc32_atomic_do_lock24 (&isem->pad);
 
   v = isem->value;
-  if ((v >> SEM_VALUE_SHIFT) == SEM_VALUE_MAX)
+  if (SEM_VALUE_MAX - (v >> SEM_VALUE_SHIFT) < n)
     {
       __sparc32_atomic_do_unlock24 (&isem->pad);
 
       __set_errno (EOVERFLOW);
       return -1;
     }
-  isem->value = v + (1 << SEM_VALUE_SHIFT);
+  isem->value = v + (n << SEM_VALUE_SHIFT);
 
   __sparc32_atomic_do_unlock24 (&isem->pad);
 
   if ((v & SEM_NWAITERS_MASK) != 0)
-    futex_wake (&isem->value, 1, private);
+    futex_wake (&isem->value, (int) n, private);
 
   return 0;
 }
+
+int
+__new_sem_post (sem_t *sem)
+{
+  return __sem_post_n ((struct new_sem *) sem, 1);
+}
 versioned_symbol (libpthread, __new_sem_post, sem_post, GLIBC_2_1);
 
+int
+__sem_post_multiple (sem_t *sem, unsigned int n)
+{
+  if (n == 0)
+    return 0;
+  if (n > SEM_VALUE_MAX)
+    {
+      __set_errno (EINVAL);
+      return -1;
+    }
+  return __sem_post_n ((struct new_sem *) sem, n);
+}
+weak_alias (__sem_post_multiple, sem_post_multiple)
+
 
 #if SHLIB_COMPAT (libpthread, GLIBC_2_0, GLIBC_2_1)
 int
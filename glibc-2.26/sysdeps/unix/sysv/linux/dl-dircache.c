@@ -0,0 +1,366 @@
+/* Cache of search directory contents for the library search.  Linux version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sysdep.h>
+#include <time.h>
+#include <dl-dircache.h>
+
+/* The contents of a directory are stored as a hash set of the hashes of
+   the file names.  A hash collision only costs an open call which fails.
+   Each listing is a separate anonymous mapping, so that it can be freed
+   regardless of which malloc was in use when it was created.  */
+struct listing
+{
+  size_t mapsize;
+  /* Identity of the directory when it was read.  */
+  dev_t dev;
+  ino64_t ino;
+  struct timespec mtime;
+  struct timespec ctime;
+  /* Set if the directory has been modified in the clock tick in which
+     it was read.  Files created later in the same tick do not change
+     the timestamps.  */
+  bool racy;
+  /* The generation in which the identity has last been checked.  */
+  unsigned int generation;
+  /* Size of SLOTS, a power of two.  */
+  uint32_t nslots;
+  uint32_t count;
+  /* Name hashes, which are never zero.  Zero marks empty slots.  */
+  uint32_t slots[];
+};
+
+/* Initial number of slots, which fits into one page together with the
+   header.  */
+#define LISTING_INITIAL_SLOTS 512
+
+/* An entry in the table of directories, keyed by the search path
+   element and the index of the hwcap subdirectory.  */
+struct dir_slot
+{
+  const void *dir;
+  size_t index;
+  struct listing *listing;
+  /* The generation plus one in which reading the directory failed.  */
+  unsigned int failed;
+  /* The search in which _dl_dircache_may_exist has last returned false
+     for this directory.  */
+  unsigned int skipped;
+};
+
+/* Open addressing hash table of directories, with linear probing.  */
+static struct dir_slot *dirs;
+static size_t dirs_size;
+static size_t dirs_used;
+static size_t dirs_mapsize;
+
+static unsigned int generation;
+
+/* Number of the current search.  Starts at one, so that directories
+   which have never been skipped are not matched.  */
+static unsigned int search = 1;
+
+/* Set when _dl_dircache_may_exist returns false in the current
+   search.  */
+static bool skipped;
+
+static uint32_t
+name_hash (const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; ++i)
+    hash = (hash ^ (unsigned char) name[i]) * 16777619u;
+  return hash != 0 ? hash : 1;
+}
+
+static struct listing *
+listing_alloc (uint32_t nslots)
+{
+  size_t size = ALIGN_UP (sizeof (struct listing) + nslots * sizeof (uint32_t),
+			  GLRO(dl_pagesize));
+  struct listing *l = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+			      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (l == MAP_FAILED)
+    return NULL;
+  l->mapsize = size;
+  l->nslots = nslots;
+  return l;
+}
+
+static void
+listing_insert (struct listing *l, uint32_t hash)
+{
+  uint32_t mask = l->nslots - 1;
+  uint32_t i = hash & mask;
+  while (l->slots[i] != 0)
+    {
+      if (l->slots[i] == hash)
+	return;
+      i = (i + 1) & mask;
+    }
+  l->slots[i] = hash;
+  ++l->count;
+}
+
+static bool
+listing_contains (const struct listing *l, uint32_t hash)
+{
+  uint32_t mask = l->nslots - 1;
+  for (uint32_t i = hash & mask; l->slots[i] != 0; i = (i + 1) & mask)
+    if (l->slots[i] == hash)
+      return true;
+  return false;
+}
+
+/* Add HASH to *PL, moving it to a larger mapping if it is half full.
+   Return false if memory could not be allocated.  */
+static bool
+listing_add (struct listing **pl, uint32_t hash)
+{
+  struct listing *l = *pl;
+  if (2 * (l->count + 1) > l->nslots)
+    {
+      struct listing *newl = listing_alloc (2 * l->nslots);
+      if (newl == NULL)
+	return false;
+      for (uint32_t i = 0; i < l->nslots; ++i)
+	if (l->slots[i] != 0)
+	  listing_insert (newl, l->slots[i]);
+      __munmap (l, l->mapsize);
+      *pl = l = newl;
+    }
+  listing_insert (l, hash);
+  return true;
+}
+
+static bool
+same_time (const struct timespec *a, const struct timespec *b)
+{
+  return a->tv_sec == b->tv_sec && a->tv_nsec == b->tv_nsec;
+}
+
+/* Return true if A is not earlier than B.  */
+static bool
+not_before (const struct timespec *a, const struct timespec *b)
+{
+  return (a->tv_sec > b->tv_sec
+	  || (a->tv_sec == b->tv_sec && a->tv_nsec >= b->tv_nsec));
+}
+
+static bool
+same_directory (const struct listing *l, const struct stat64 *st)
+{
+  return (l->dev == st->st_dev && l->ino == st->st_ino
+	  && same_time (&l->mtime, &st->st_mtim)
+	  && same_time (&l->ctime, &st->st_ctim));
+}
+
+/* Read the directory DIRNAME.  Return NULL if it cannot be read or has
+   been modified while it was read.  */
+static struct listing *
+read_listing (const char *dirname)
+{
+  int fd = __open (dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+
+  /* The kernel takes file timestamps from the coarse clock.  If the
+     clock cannot be read, the listing is treated as racy.  */
+  struct timespec start = { 0, 0 };
+  INTERNAL_SYSCALL_DECL (err);
+  INTERNAL_SYSCALL (clock_gettime, err, 2, CLOCK_REALTIME_COARSE, &start);
+
+  struct stat64 st;
+  struct listing *l = NULL;
+  if (__fxstat64 (_STAT_VER, fd, &st) == 0)
+    l = listing_alloc (LISTING_INITIAL_SLOTS);
+  if (l != NULL)
+    {
+      l->dev = st.st_dev;
+      l->ino = st.st_ino;
+      l->mtime = st.st_mtim;
+      l->ctime = st.st_ctim;
+      l->racy = (not_before (&st.st_mtim, &start)
+		 || not_before (&st.st_ctim, &start));
+      l->generation = generation;
+
+      char buf[4096] __attribute__ ((aligned (__alignof__ (struct dirent64))));
+      ssize_t n;
+      bool ok = true;
+      while (ok && (n = __getdents64 (fd, buf, sizeof (buf))) > 0)
+	for (ssize_t off = 0; ok && off < n; )
+	  {
+	    struct dirent64 *d = (struct dirent64 *) (buf + off);
+	    off += d->d_reclen;
+	    ok = listing_add (&l, name_hash (d->d_name, strlen (d->d_name)));
+	  }
+
+      if (!ok || n < 0
+	  || __fxstat64 (_STAT_VER, fd, &st) != 0
+	  || !same_directory (l, &st))
+	{
+	  __munmap (l, l->mapsize);
+	  l = NULL;
+	}
+    }
+
+  __close (fd);
+  return l;
+}
+
+/* Return the slot for DIR and INDEX, which is empty if the directory
+   has not been seen before.  Return NULL if the table cannot be
+   enlarged.  */
+static struct dir_slot *
+find_slot (const void *dir, size_t index)
+{
+  if (2 * (dirs_used + 1) > dirs_size)
+    {
+      size_t newsize = dirs_size == 0 ? 64 : 2 * dirs_size;
+      size_t mapsize = ALIGN_UP (newsize * sizeof (struct dir_slot),
+				 GLRO(dl_pagesize));
+      struct dir_slot *newdirs = __mmap (NULL, mapsize,
+					 PROT_READ | PROT_WRITE,
+					 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (newdirs == MAP_FAILED)
+	return NULL;
+
+      struct dir_slot *olddirs = dirs;
+      size_t oldsize = dirs_size;
+      size_t oldmapsize = dirs_mapsize;
+      dirs = newdirs;
+      dirs_size = newsize;
+      dirs_mapsize = mapsize;
+      for (size_t i = 0; i < oldsize; ++i)
+	if (olddirs[i].dir != NULL)
+	  *find_slot (olddirs[i].dir, olddirs[i].index) = olddirs[i];
+      if (olddirs != NULL)
+	__munmap (olddirs, oldmapsize);
+    }
+
+  size_t mask = dirs_size - 1;
+  size_t i = (((uintptr_t) dir >> 4) * 31 + index) & mask;
+  while (dirs[i].dir != NULL
+	 && (dirs[i].dir != dir || dirs[i].index != index))
+    i = (i + 1) & mask;
+  return &dirs[i];
+}
+
+bool
+_dl_dircache_may_exist (const void *dir, size_t index, const char *dirname,
+			const char *name, size_t namelen)
+{
+  /* The current directory can change, so relative directories are not
+     cached.  */
+  if (dirname[0] != '/')
+    return true;
+
+  struct dir_slot *slot = find_slot (dir, index);
+  if (slot == NULL)
+    return true;
+  if (slot->dir == NULL)
+    {
+      slot->dir = dir;
+      slot->index = index;
+      ++dirs_used;
+    }
+
+  struct listing *l = slot->listing;
+  if (l != NULL && l->generation != generation)
+    {
+      /* Adding or removing a file changes the modification time of the
+	 directory.  */
+      struct stat64 st;
+      if (__xstat64 (_STAT_VER, dirname, &st) == 0 && same_directory (l, &st))
+	l->generation = generation;
+      else
+	{
+	  __munmap (l, l->mapsize);
+	  slot->listing = l = NULL;
+	}
+    }
+
+  if (l == NULL)
+    {
+      /* Do not try again in this generation if the directory cannot be
+	 read, for example because it is not readable but searchable.  */
+      if (slot->failed == generation + 1)
+	return true;
+      if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
+	_dl_debug_printf ("  reading directory=%s\n", dirname);
+      l = read_listing (dirname);
+      if (l == NULL)
+	{
+	  slot->failed = generation + 1;
+	  return true;
+	}
+      slot->listing = l;
+    }
+
+  if (listing_contains (l, name_hash (name, namelen - 1)))
+    return true;
+  slot->skipped = search;
+  skipped = true;
+  return false;
+}
+
+void
+_dl_dircache_new_generation (void)
+{
+  ++generation;
+}
+
+void
+_dl_dircache_new_search (void)
+{
+  ++search;
+  skipped = false;
+}
+
+bool
+_dl_dircache_refresh_skipped (void)
+{
+  if (!skipped)
+    return false;
+
+  /* The listings have been checked against the timestamps of the
+     directories at the start of this dlopen call, so only the racy
+     ones can miss a file.  The listings of the other directories are
+     still valid because the file was not skipped there.  */
+  bool refreshed = false;
+  for (size_t i = 0; i < dirs_size; ++i)
+    if (dirs[i].skipped == search && dirs[i].listing != NULL
+	&& dirs[i].listing->racy)
+      {
+	__munmap (dirs[i].listing, dirs[i].listing->mapsize);
+	dirs[i].listing = NULL;
+	refreshed = true;
+      }
+
+  /* A second search must not refresh the same directories again.  */
+  _dl_dircache_new_search ();
+  return refreshed;
+}
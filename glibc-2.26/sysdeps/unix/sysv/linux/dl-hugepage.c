@@ -0,0 +1,120 @@
+/* Huge page backing for the text of shared objects.  Linux version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <dl-hugepage.h>
+
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
+
+/* The values of the glibc.rtld.hugepage_text tunable.  With
+   hugepage_text_madvise, the object is mapped at an address which
+   allows the largest possible part of its text to use huge pages, and
+   the file mapping of the text is marked with MADV_HUGEPAGE, so that
+   khugepaged can collapse it into huge pages if the kernel supports
+   transparent huge pages for read-only file mappings.  The text stays
+   a file mapping, so it is still shared with other processes and
+   visible to debuggers and profilers.  */
+enum
+  {
+    hugepage_text_disabled = 0,
+    hugepage_text_madvise = 1
+  };
+
+static int mode = -1;
+static size_t hugepage_size;
+
+/* Return the size of the huge pages used for transparent huge pages,
+   or 0 if they are not available.  */
+static size_t
+read_hugepage_size (void)
+{
+  int fd = __open ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+		   O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return 0;
+
+  char buf[32];
+  ssize_t n = __libc_read (fd, buf, sizeof (buf));
+  __close (fd);
+
+  size_t size = 0;
+  for (ssize_t i = 0; i < n && buf[i] >= '0' && buf[i] <= '9'; ++i)
+    size = size * 10 + buf[i] - '0';
+
+  /* Ignore values which are not a power of two multiple of the page
+     size.  */
+  if (size <= GLRO(dl_pagesize) || (size & (size - 1)) != 0)
+    return 0;
+  return size;
+}
+
+static void
+init_mode (void)
+{
+  int32_t value = hugepage_text_disabled;
+#if HAVE_TUNABLES
+  value = TUNABLE_GET (hugepage_text, int32_t, NULL);
+#endif
+  if (value != hugepage_text_disabled)
+    {
+      hugepage_size = read_hugepage_size ();
+      if (hugepage_size == 0)
+	value = hugepage_text_disabled;
+    }
+  mode = value;
+}
+
+size_t
+_dl_hugepage_text_align (ElfW(Addr) start, ElfW(Addr) end, ElfW(Off) offset,
+			 ElfW(Addr) *residue)
+{
+  if (__glibc_unlikely (mode < 0))
+    init_mode ();
+  if (__glibc_likely (mode == hugepage_text_disabled))
+    return 0;
+
+  /* The page cache only uses huge pages for ranges of the file which
+     start at a multiple of the huge page size, so these have to be
+     mapped at an aligned address.  */
+  size_t size = hugepage_size;
+  ElfW(Addr) bias = (offset - start) & (size - 1);
+
+  /* Only use huge pages if the segment covers at least one of them.  */
+  if (ALIGN_UP (start + bias, size) >= ALIGN_DOWN (end + bias, size))
+    return 0;
+
+  *residue = bias;
+  return size;
+}
+
+void
+_dl_hugepage_text_setup (ElfW(Addr) start, ElfW(Addr) end)
+{
+  size_t size = hugepage_size;
+  ElfW(Addr) hstart = ALIGN_UP (start, size);
+  ElfW(Addr) hend = ALIGN_DOWN (end, size);
+  if (hstart < hend)
+    (void) __madvise ((void *) hstart, hend - hstart, MADV_HUGEPAGE);
+}
@@ -0,0 +1,60 @@
+/* Restartable sequences registration for the initial thread.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <ldsodefs.h>
+#include <rseq-internal.h>
+
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE pthread
+#endif
+#include <elf/dl-tunables.h>
+
+/* These are only written here, before RELRO protection is applied, and
+   read through the const declarations in <sys/rseq.h> elsewhere.  Do not
+   read them in this file: the compiler could assume that they are
+   zero.  */
+const unsigned int __rseq_flags;
+const unsigned int __rseq_size attribute_relro;
+const ptrdiff_t __rseq_offset attribute_relro;
+
+void
+_dl_rseq_init (void)
+{
+  bool do_rseq = true;
+#if HAVE_TUNABLES
+  do_rseq = TUNABLE_GET (rseq, int32_t, NULL) != 0;
+#endif
+  struct pthread *self = THREAD_SELF;
+  if (!rseq_register_current_thread (self, do_rseq))
+    return;
+
+  /* New threads register their area only if the initial thread could do
+     so, which pthread_create determines from __rseq_size.  */
+  extern unsigned int rseq_size __asm__ ("__rseq_size");
+  rseq_size = sizeof (self->rseq_area);
+
+#ifdef RSEQ_SIG
+# if TLS_TCB_AT_TP
+  /* The thread pointer points to the thread descriptor.  */
+  extern ptrdiff_t rseq_offset __asm__ ("__rseq_offset");
+  rseq_offset = offsetof (struct pthread, rseq_area);
+# else
+#  error "Compute __rseq_offset for this architecture before defining RSEQ_SIG"
+# endif
+#endif
+}
@@ -75,6 +75,10 @@ _dl_ppc64_addr_sym_match (const struct link_map *l, const ElfW(Sym) *sym,
 #define DL_ADDR_SYM_MATCH(L, SYM, MATCHSYM, ADDR) \
   _dl_ppc64_addr_sym_match (L, SYM, MATCHSYM, ADDR)
 
+/* Function descriptors can match addresses far away from st_value.  */
+#undef DL_ADDR_SYM_INDEX
+#define DL_ADDR_SYM_INDEX 0
+
 #endif
 
 #endif /* ldsodefs.h */
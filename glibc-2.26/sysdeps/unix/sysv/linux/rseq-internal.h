@@ -0,0 +1,53 @@
+/* Restartable sequences internal API.  Linux implementation.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef RSEQ_INTERNAL_H
+#define RSEQ_INTERNAL_H
+
+#include <stdbool.h>
+#include <sysdep.h>
+#include <tls.h>
+#include <sys/rseq.h>
+
+/* Register the rseq area of the thread described by SELF, which must be
+   the calling thread, if DO_RSEQ.  Returns true on success.  On failure,
+   the cpu_id field of the area is set to RSEQ_CPU_ID_REGISTRATION_FAILED
+   so that users fall back to other means of determining the CPU.  */
+static inline bool
+rseq_register_current_thread (struct pthread *self, bool do_rseq)
+{
+#if defined __NR_rseq && defined RSEQ_SIG
+  if (do_rseq)
+    {
+      INTERNAL_SYSCALL_DECL (err);
+      int ret = INTERNAL_SYSCALL_CALL (rseq, err, &self->rseq_area,
+				       sizeof (self->rseq_area), 0, RSEQ_SIG);
+      if (!INTERNAL_SYSCALL_ERROR_P (ret, err))
+	return true;
+    }
+#endif
+  THREAD_SETMEM (self, rseq_area.cpu_id, RSEQ_CPU_ID_REGISTRATION_FAILED);
+  return false;
+}
+
+/* Register the rseq area of the initial thread, unless disabled with the
+   glibc.pthread.rseq tunable, and publish __rseq_size and __rseq_offset
+   accordingly.  Called once the thread pointer has been set up.  */
+extern void _dl_rseq_init (void) attribute_hidden;
+
+#endif /* rseq-internal.h */
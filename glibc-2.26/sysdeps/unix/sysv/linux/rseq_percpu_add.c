@@ -0,0 +1,35 @@
+/* Add to the counter of the current CPU.  Generic version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <sched.h>
+#include <sys/rseq.h>
+
+/* Without an rseq critical section for this architecture, the thread may
+   migrate after determining the CPU, so the update has to be atomic.  */
+int
+rseq_percpu_add (void *base, size_t stride, intptr_t value)
+{
+  int cpu = sched_getcpu ();
+  if (cpu < 0)
+    return -1;
+
+  intptr_t *counter = (intptr_t *) ((char *) base + cpu * stride);
+  atomic_fetch_add_relaxed (counter, value);
+  return cpu;
+}
@@ -18,6 +18,7 @@
 #include <errno.h>
 #include <sched.h>
 #include <sysdep.h>
+#include <tls.h>
 
 #ifdef HAVE_GETCPU_VSYSCALL
 # define HAVE_VSYSCALL
@@ -27,6 +28,14 @@
 int
 sched_getcpu (void)
 {
+#ifdef RSEQ_SIG
+  /* The kernel keeps the CPU number in the registered rseq area up to
+     date, so we do not need a system call if registration succeeded.  */
+  int cpu_id = THREAD_GETMEM (THREAD_SELF, rseq_area.cpu_id);
+  if (__glibc_likely (cpu_id >= 0))
+    return cpu_id;
+#endif
+
 #ifdef __NR_getcpu
   unsigned int cpu;
   int r = INLINE_VSYSCALL (getcpu, 3, &cpu, NULL, NULL);
@@ -37,3 +46,4 @@ sched_getcpu (void)
   return -1;
 #endif
 }
+libc_hidden_def (sched_getcpu)
@@ -0,0 +1,114 @@
+/* Restartable sequences.  Linux version.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef _SYS_RSEQ_H
+#define _SYS_RSEQ_H	1
+
+/* The GNU C Library registers a restartable sequences area for every
+   thread it creates, including the initial thread.  Applications can
+   use it to implement per-CPU data structures.  */
+
+#include <features.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <bits/rseq.h>
+
+/* The definitions below follow the kernel ABI.  They are used instead
+   of those in <linux/rseq.h>, so that this header and the layout of the
+   thread descriptor do not depend on the kernel headers present when the
+   GNU C Library is built.  <linux/rseq.h> cannot be included in the same
+   translation unit.  */
+
+/* Values of the cpu_id field other than CPU numbers.  */
+enum rseq_cpu_id_state
+  {
+    RSEQ_CPU_ID_UNINITIALIZED = -1,
+    RSEQ_CPU_ID_REGISTRATION_FAILED = -2,
+  };
+
+/* Flags for the registration system call.  */
+enum rseq_flags
+  {
+    RSEQ_FLAG_UNREGISTER = (1 << 0),
+  };
+
+/* Flags which modify the restart behavior of a critical section.  */
+enum rseq_cs_flags
+  {
+    RSEQ_CS_FLAG_NO_RESTART_ON_PREEMPT = (1 << 0),
+    RSEQ_CS_FLAG_NO_RESTART_ON_SIGNAL = (1 << 1),
+    RSEQ_CS_FLAG_NO_RESTART_ON_MIGRATE = (1 << 2),
+  };
+
+/* Descriptor of a restartable critical section.  The kernel moves the
+   instruction pointer of a thread interrupted between START_IP and
+   START_IP + POST_COMMIT_OFFSET to ABORT_IP, which must be preceded by
+   the 32-bit value RSEQ_SIG.  */
+struct rseq_cs
+  {
+    /* Version of this structure.  */
+    uint32_t version;
+    /* enum rseq_cs_flags.  */
+    uint32_t flags;
+    uint64_t start_ip;
+    /* Offset from start_ip.  */
+    uint64_t post_commit_offset;
+    uint64_t abort_ip;
+  } __attribute__ ((__aligned__ (32)));
+
+/* The per-thread area shared with the kernel.  */
+struct rseq
+  {
+    /* CPU number on which the thread last returned to user space, or
+       RSEQ_CPU_ID_UNINITIALIZED.  Always a valid CPU number.  */
+    uint32_t cpu_id_start;
+    /* Like cpu_id_start, but negative (see enum rseq_cpu_id_state) if
+       registration has not happened or has failed.  */
+    uint32_t cpu_id;
+    /* Address of the struct rseq_cs of the currently executing critical
+       section, or zero.  Always 64 bits wide.  */
+    uint64_t rseq_cs;
+    /* enum rseq_cs_flags applying to all critical sections.  */
+    uint32_t flags;
+  } __attribute__ ((__aligned__ (32)));
+
+__BEGIN_DECLS
+
+/* Offset from the thread pointer to the struct rseq area of the current
+   thread.  */
+extern const ptrdiff_t __rseq_offset;
+
+/* Size of the registered struct rseq area, or zero if the GNU C Library
+   did not register it (because the kernel does not support restartable
+   sequences, or registration was disabled).  */
+extern const unsigned int __rseq_size;
+
+/* Flags used during registration.  */
+extern const unsigned int __rseq_flags;
+
+/* Add VALUE to the intptr_t counter of the current CPU, which is located
+   at BASE + CPU * STRIDE.  The update is not atomic with respect to other
+   CPUs; it relies on the per-CPU layout instead.  Returns the number of
+   the CPU whose counter has been updated, or -1 if no update was
+   possible because per-CPU information is not available.  */
+extern int rseq_percpu_add (void *__base, size_t __stride, intptr_t __value)
+     __THROW __nonnull ((1));
+
+__END_DECLS
+
+#endif /* sys/rseq.h */
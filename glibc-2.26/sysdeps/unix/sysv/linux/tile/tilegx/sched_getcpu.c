@@ -85,3 +85,4 @@ sched_getcpu (void)
   /* Extract Y coord from bits 7..10 and X coord from bits 18..21.  */
   return ((coord >> 7) & 0xf) * w + ((coord >> 18) & 0xf);
 }
+libc_hidden_def (sched_getcpu)
@@ -0,0 +1,109 @@
+/* Test restartable sequences registration and rseq_percpu_add.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/rseq.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+#define NTHREADS 4
+#define ITERATIONS 100000
+
+/* One counter per CPU, each on its own cache line.  */
+struct counter
+{
+  intptr_t value;
+  char pad[64 - sizeof (intptr_t)];
+};
+
+static struct counter *counters;
+static int ncpus;
+
+/* Check that sched_getcpu agrees with the kernel while the calling
+   thread is bound to a single CPU.  */
+static void
+check_cpu (void)
+{
+  cpu_set_t set;
+  TEST_VERIFY_EXIT (sched_getaffinity (0, sizeof (set), &set) == 0);
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET (cpu, &set))
+      {
+	cpu_set_t one;
+	CPU_ZERO (&one);
+	CPU_SET (cpu, &one);
+	TEST_VERIFY_EXIT (sched_setaffinity (0, sizeof (one), &one) == 0);
+	TEST_VERIFY (sched_getcpu () == cpu);
+	break;
+      }
+  TEST_VERIFY_EXIT (sched_setaffinity (0, sizeof (set), &set) == 0);
+}
+
+static void *
+tf (void *closure)
+{
+  check_cpu ();
+  for (int i = 0; i < ITERATIONS; ++i)
+    {
+      int cpu = rseq_percpu_add (counters, sizeof (*counters), 1);
+      TEST_VERIFY_EXIT (cpu >= -1 && cpu < ncpus);
+      if (cpu < 0)
+	/* No per-CPU information is available.  */
+	return NULL;
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  printf ("info: __rseq_size = %u, __rseq_offset = %td\n",
+	  __rseq_size, __rseq_offset);
+  TEST_VERIFY (__rseq_size == 0 || __rseq_size == sizeof (struct rseq));
+  TEST_VERIFY (__rseq_flags == 0);
+
+  ncpus = sysconf (_SC_NPROCESSORS_CONF);
+  TEST_VERIFY_EXIT (ncpus > 0);
+  counters = xcalloc (ncpus, sizeof (*counters));
+
+  check_cpu ();
+
+  pthread_t threads[NTHREADS];
+  for (int i = 0; i < NTHREADS; ++i)
+    threads[i] = xpthread_create (NULL, tf, NULL);
+  for (int i = 0; i < NTHREADS; ++i)
+    xpthread_join (threads[i]);
+
+  intptr_t sum = 0;
+  for (int cpu = 0; cpu < ncpus; ++cpu)
+    sum += counters[cpu].value;
+  if (sum == 0)
+    puts ("info: rseq_percpu_add is not supported");
+  else
+    TEST_VERIFY (sum == (intptr_t) NTHREADS * ITERATIONS);
+
+  free (counters);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,681 @@
+/* Parallel relocation of the initially loaded objects.  Linux/x86-64.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* The objects are relocated in the same order as by the sequential loop
+   in dl_main, but runs of consecutive objects are handed out to helper
+   threads.  Relocating an object only writes to the object itself and
+   only reads the symbol tables of other objects, which do not change,
+   so the objects of a run can be processed in any order.  The
+   exception is code which runs during relocation and can read relocated
+   data of other objects: the IFUNC resolvers.
+
+   The helper threads therefore relocate with __RTLD_NOIFUNC, which
+   leaves the address of the resolver in place of its result.  The
+   relocations which can be affected are found up front: IRELATIVE
+   relocations, and relocations against a symbol which is an IFUNC
+   symbol itself or has the name of an IFUNC symbol exported by any of
+   the objects.  Once all objects of a run have been relocated, the main
+   thread applies these relocations again, calling the resolvers, in the
+   sequential order of the objects.  All objects before an object in
+   that order are then completely relocated when its resolvers run, as
+   in the sequential loop.  The RELRO segments of these objects are
+   protected only afterwards.
+
+   Objects which cannot be handled like this end the current run and
+   are relocated completely on the main thread, only after all objects
+   before them:
+
+   - the main program, because copy relocations read the data of the
+     objects which define the copied symbols;
+   - objects with text relocations which can call IFUNC resolvers,
+     because their text segment is only writable during relocation.
+
+   As a result, the helper threads never run IFUNC resolvers or any
+   other code outside the dynamic linker.
+
+   Each helper thread gets a private copy of the thread descriptor of
+   the main thread.  The relocation code does not use thread-local data,
+   but the stack protector reads the guard from the thread control
+   block.
+
+   The symbol lookup code writes to shared data in three places: the
+   l_used flag of the defining object, the table of STB_GNU_UNIQUE
+   symbols together with the minimal malloc which allocates it, and the
+   relocation statistics counters.  l_used is set for all objects up
+   front, and the unique symbol table is protected by replacing the rtld
+   lock functions with a spin lock while the helper threads run.  The
+   counters are updated without synchronization and can be inaccurate;
+   they are only printed with LD_DEBUG=statistics, which disables
+   parallel relocation, like all other LD_DEBUG options.  */
+
+#include <atomic.h>
+#include <dl-hash.h>
+#include <dl-machine.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <lowlevellock-futex.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <tls.h>
+
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+#endif
+#include <elf/dl-tunables.h>
+
+/* Stack size of the helper threads.  They only run the relocation code
+   of the dynamic linker.  The private thread descriptor is placed at the
+   top of the stack area.  */
+#define HELPER_STACK_SIZE (256 * 1024)
+
+/* An object to be relocated.  */
+struct object
+{
+  struct link_map *map;
+  /* The relocations of MAP which can call IFUNC resolvers, as indices
+     into the array of all such relocations.  */
+  size_t ifunc_start;
+  size_t ifunc_count;
+  /* l_relro_size of MAP.  It is cleared while the helper threads run,
+     so that _dl_relocate_object leaves the RELRO segment writable for
+     the IFUNC relocations.  */
+  size_t relro_size;
+  /* Whether MAP is relocated completely on the main thread, in the
+     sequential order.  */
+  bool ordered;
+};
+
+/* The work queue shared by the main thread and the helper threads.
+   OBJECTS is ordered like the sequential relocation loop.  The objects
+   in [NEXT, END) can be claimed by any thread.  NEXT and END only
+   increase.  */
+static struct
+{
+  struct object *objects;
+  int reloc_mode;
+  /* Next object to be claimed.  */
+  unsigned int next;
+  /* End of the current run.  */
+  unsigned int end;
+  /* Number of objects of the current run which have not been relocated
+     yet.  Futex word for the main thread.  */
+  unsigned int pending;
+  /* Incremented when a new run is published.  Futex word for idle
+     helper threads.  */
+  unsigned int generation;
+  /* Set when the helper threads have to exit.  */
+  int stop;
+} queue;
+
+/* Claim the next object of the current run and relocate it on thread
+   HELPER, which is zero for the main thread.  Returns false if all
+   objects of the run have been claimed.  */
+static bool
+relocate_next (unsigned int helper)
+{
+  unsigned int idx = atomic_load_relaxed (&queue.next);
+  do
+    if (idx >= atomic_load_acquire (&queue.end))
+      return false;
+  while (!atomic_compare_exchange_weak_acquire (&queue.next, &idx, idx + 1));
+
+  struct link_map *l = queue.objects[idx].map;
+  l->l_reloc_helper = helper;
+  _dl_relocate_object (l, l->l_scope, queue.reloc_mode | __RTLD_NOIFUNC, 0);
+
+  if (atomic_fetch_add_release (&queue.pending, -1) == 1)
+    lll_futex_wake (&queue.pending, 1, LLL_PRIVATE);
+  return true;
+}
+
+static int
+helper_thread (void *closure)
+{
+  unsigned int helper = (uintptr_t) closure;
+  while (true)
+    {
+      /* Read the generation before looking for work, so that a run
+	 published after the check below makes the futex wait return
+	 immediately.  */
+      unsigned int generation = atomic_load_acquire (&queue.generation);
+      if (atomic_load_relaxed (&queue.stop))
+	return 0;
+      while (relocate_next (helper))
+	;
+      lll_futex_wait (&queue.generation, generation, LLL_PRIVATE);
+    }
+}
+
+/* Make the objects up to END available to the helper threads.  */
+static void
+publish (unsigned int end)
+{
+  atomic_store_release (&queue.end, end);
+  atomic_fetch_add_release (&queue.generation, 1);
+  lll_futex_wake (&queue.generation, INT_MAX, LLL_PRIVATE);
+}
+
+/* Lock functions installed as GL(dl_rtld_lock_recursive) and
+   GL(dl_rtld_unlock_recursive) while the helper threads run.  Only the
+   lock of the unique symbol table is taken during relocation, and never
+   recursively, so a single spin lock is sufficient.  */
+static int reloc_lock;
+
+static void
+reloc_lock_lock (void *lock)
+{
+  while (atomic_exchange_acquire (&reloc_lock, 1) != 0)
+    atomic_spin_nop ();
+}
+
+static void
+reloc_lock_unlock (void *lock)
+{
+  atomic_store_release (&reloc_lock, 0);
+}
+
+/* Names of the IFUNC symbols exported by the objects being relocated,
+   as an open-addressing hash table with MASK + 1 slots.  */
+struct ifunc_names
+{
+  unsigned int mask;
+  struct ifunc_name
+  {
+    const char *name;
+    unsigned long int hash;
+  } *slots;
+};
+
+static void
+ifunc_names_add (struct ifunc_names *names, const char *name)
+{
+  unsigned long int hash = _dl_elf_hash (name);
+  unsigned int i = hash & names->mask;
+  while (names->slots[i].name != NULL)
+    {
+      if (names->slots[i].hash == hash
+	  && strcmp (names->slots[i].name, name) == 0)
+	return;
+      i = (i + 1) & names->mask;
+    }
+  names->slots[i].name = name;
+  names->slots[i].hash = hash;
+}
+
+static bool
+ifunc_names_contain (const struct ifunc_names *names, const char *name)
+{
+  unsigned long int hash = _dl_elf_hash (name);
+  unsigned int i = hash & names->mask;
+  while (names->slots[i].name != NULL)
+    {
+      if (names->slots[i].hash == hash
+	  && strcmp (names->slots[i].name, name) == 0)
+	return true;
+      i = (i + 1) & names->mask;
+    }
+  return false;
+}
+
+/* Count the IFUNC symbols defined in the dynamic symbol table of L and
+   add their names to NAMES unless it is NULL.  Returns -1 if the symbols
+   cannot be enumerated because L has no hash table.  */
+static int
+add_ifuncs (struct link_map *l, struct ifunc_names *names)
+{
+  const ElfW(Sym) *symtab = (const ElfW(Sym) *) D_PTR (l, l_info[DT_SYMTAB]);
+  const char *strtab = (const char *) D_PTR (l, l_info[DT_STRTAB]);
+  int count = 0;
+
+#define VISIT(symndx)							      \
+  do									      \
+    {									      \
+      const ElfW(Sym) *sym = &symtab[symndx];				      \
+      if (ELFW(ST_TYPE) (sym->st_info) == STT_GNU_IFUNC			      \
+	  && sym->st_shndx != SHN_UNDEF)				      \
+	{								      \
+	  ++count;							      \
+	  if (names != NULL)						      \
+	    ifunc_names_add (names, strtab + sym->st_name);		      \
+	}								      \
+    }									      \
+  while (0)
+
+  if (l->l_info[DT_ADDRTAGIDX (DT_GNU_HASH) + DT_NUM + DT_THISPROCNUM
+		+ DT_VERSIONTAGNUM + DT_EXTRANUM + DT_VALNUM] != NULL)
+    {
+      /* The GNU hash table only references defined symbols.  */
+      for (Elf_Symndx bucket = 0; bucket < l->l_nbuckets; ++bucket)
+	{
+	  Elf32_Word symndx = l->l_gnu_buckets[bucket];
+	  if (symndx != 0)
+	    {
+	      const Elf32_Word *hasharr = &l->l_gnu_chain_zero[symndx];
+	      do
+		VISIT (symndx++);
+	      while ((*hasharr++ & 1u) == 0);
+	    }
+	}
+    }
+  else if (l->l_info[DT_HASH] != NULL)
+    {
+      Elf32_Word nsyms = ((Elf_Symndx *) D_PTR (l, l_info[DT_HASH]))[1];
+      for (Elf32_Word symndx = 0; symndx < nsyms; ++symndx)
+	VISIT (symndx);
+    }
+  else
+    /* Without any hash table the number of symbols is unknown.  */
+    return -1;
+#undef VISIT
+
+  return count;
+}
+
+/* Store in OUT, unless it is NULL, the SIZE bytes of relocations of L
+   at RELA which can call an IFUNC resolver, and return their number.
+   These are IRELATIVE relocations and, unless LAZY is true, relocations
+   against a symbol which is an IFUNC symbol itself or has the name of
+   one in NAMES.  Lazy PLT relocations are bound on the first call.  */
+static size_t
+scan_relocs (struct link_map *l, const ElfW(Rela) *rela, ElfW(Addr) size,
+	     bool lazy, const struct ifunc_names *names,
+	     const ElfW(Rela) **out)
+{
+  const ElfW(Sym) *symtab = (const ElfW(Sym) *) D_PTR (l, l_info[DT_SYMTAB]);
+  const char *strtab = (const char *) D_PTR (l, l_info[DT_STRTAB]);
+  const ElfW(Rela) *end = (const void *) ((const char *) rela + size);
+  size_t count = 0;
+  /* Relocations against the same symbol are often adjacent.  */
+  Elf32_Word last_symndx = 0;
+  bool last_ifunc = false;
+
+  for (; rela < end; ++rela)
+    {
+      if (ELFW(R_TYPE) (rela->r_info) != R_X86_64_IRELATIVE)
+	{
+	  Elf32_Word symndx = ELFW(R_SYM) (rela->r_info);
+	  if (lazy || symndx == 0)
+	    continue;
+	  if (symndx != last_symndx)
+	    {
+	      const ElfW(Sym) *sym = &symtab[symndx];
+	      last_symndx = symndx;
+	      last_ifunc
+		= (ELFW(ST_TYPE) (sym->st_info) == STT_GNU_IFUNC
+		   || (ELFW(ST_BIND) (sym->st_info) != STB_LOCAL
+		       && ifunc_names_contain (names, strtab + sym->st_name)));
+	    }
+	  if (!last_ifunc)
+	    continue;
+	}
+      if (out != NULL)
+	out[count] = rela;
+      ++count;
+    }
+  return count;
+}
+
+/* Store in OUT, unless it is NULL, the relocations of L which can call
+   an IFUNC resolver when L is relocated with RELOC_MODE, in the order
+   in which they are processed, and return their number.  This follows
+   ELF_DYNAMIC_RELOCATE.  */
+static size_t
+find_ifunc_relocs (struct link_map *l, int reloc_mode,
+		   const struct ifunc_names *names, const ElfW(Rela) **out)
+{
+  ElfW(Addr) start = 0;
+  ElfW(Addr) size = 0;
+  if (l->l_info[DT_RELA] != NULL)
+    {
+      start = D_PTR (l, l_info[DT_RELA]);
+      size = l->l_info[DT_RELASZ]->d_un.d_val;
+    }
+  ElfW(Addr) pltstart = 0;
+  ElfW(Addr) pltsize = 0;
+  if (l->l_info[DT_JMPREL] != NULL)
+    {
+      pltstart = D_PTR (l, l_info[DT_JMPREL]);
+      pltsize = l->l_info[DT_PLTRELSZ]->d_un.d_val;
+      if (start + size == pltstart + pltsize)
+	size -= pltsize;
+    }
+
+  /* Skip the relative relocations, which never refer to a symbol.  */
+  if (l->l_info[VERSYMIDX (DT_RELACOUNT)] != NULL)
+    {
+      ElfW(Addr) relsize = (l->l_info[VERSYMIDX (DT_RELACOUNT)]->d_un.d_val
+			    * sizeof (ElfW(Rela)));
+      if (relsize > size)
+	relsize = size;
+      start += relsize;
+      size -= relsize;
+    }
+
+  bool lazy = (reloc_mode & RTLD_LAZY) != 0 && l->l_info[DT_BIND_NOW] == NULL;
+  size_t count = scan_relocs (l, (const void *) start, size, false, names,
+			      out);
+  return count + scan_relocs (l, (const void *) pltstart, pltsize, lazy,
+			      names, out != NULL ? out + count : NULL);
+}
+
+/* Apply the relocation RELA of L again, calling the IFUNC resolver if
+   it is an IRELATIVE relocation or bound to an IFUNC symbol.  The
+   helper threads stored the address of the resolver instead.  */
+static void
+relocate_ifunc (struct link_map *l, const ElfW(Rela) *rela)
+{
+  ElfW(Addr) *const reloc_addr = (void *) (l->l_addr + rela->r_offset);
+  const unsigned long int r_type = ELFW(R_TYPE) (rela->r_info);
+
+  if (r_type == R_X86_64_IRELATIVE)
+    {
+      ElfW(Addr) value = l->l_addr + rela->r_addend;
+      *reloc_addr = ((ElfW(Addr) (*) (void)) value) ();
+      return;
+    }
+
+  /* Look up the symbol like RESOLVE_MAP in _dl_relocate_object.  */
+  const ElfW(Sym) *symtab = (const ElfW(Sym) *) D_PTR (l, l_info[DT_SYMTAB]);
+  const char *strtab = (const char *) D_PTR (l, l_info[DT_STRTAB]);
+  Elf32_Word symndx = ELFW(R_SYM) (rela->r_info);
+  const ElfW(Sym) *sym = &symtab[symndx];
+  struct link_map *sym_map = l;
+  if (ELFW(ST_BIND) (sym->st_info) != STB_LOCAL
+      && !dl_symbol_visibility_binds_local_p (sym))
+    {
+      const struct r_found_version *version = NULL;
+      if (l->l_info[VERSYMIDX (DT_VERSYM)] != NULL)
+	{
+	  const ElfW(Half) *versym
+	    = (const void *) D_PTR (l, l_info[VERSYMIDX (DT_VERSYM)]);
+	  version = &l->l_versions[versym[symndx] & 0x7fff];
+	  if (version->hash == 0)
+	    version = NULL;
+	}
+      sym_map = _dl_lookup_symbol_x (strtab + sym->st_name, l, &sym,
+				     l->l_scope, version,
+				     elf_machine_type_class (r_type),
+				     DL_LOOKUP_ADD_DEPENDENCY, NULL);
+    }
+
+  /* A reference to a symbol with the name of an IFUNC symbol may bind
+     to a different definition, which the helper thread has already
+     applied correctly.  */
+  if (sym == NULL || ELFW(ST_TYPE) (sym->st_info) != STT_GNU_IFUNC
+      || sym->st_shndx == SHN_UNDEF)
+    return;
+
+  ElfW(Addr) value = sym_map->l_addr + sym->st_value;
+  value = ((ElfW(Addr) (*) (void)) value) ();
+  switch (r_type)
+    {
+    case R_X86_64_GLOB_DAT:
+    case R_X86_64_JUMP_SLOT:
+    case R_X86_64_64:
+      *reloc_addr = value + rela->r_addend;
+      break;
+    case R_X86_64_32:
+      *(unsigned int *) reloc_addr = value + rela->r_addend;
+      break;
+    case R_X86_64_PC32:
+      *(unsigned int *) reloc_addr
+	= value + rela->r_addend - (ElfW(Addr)) reloc_addr;
+      break;
+    default:
+      /* The other relocation types do not use the address of the
+	 symbol.  */
+      break;
+    }
+}
+
+/* Apply the IFUNC relocations of the objects in [START, END) which the
+   helper threads have relocated, in the sequential order, and protect
+   their RELRO segments.  Within an object, IRELATIVE relocations are
+   processed last, like in elf_dynamic_do_Rela.  */
+static void
+finish_run (struct object *objects, unsigned int start, unsigned int end,
+	    const ElfW(Rela) **ifunc_relocs)
+{
+  for (unsigned int i = start; i < end; ++i)
+    {
+      struct object *o = &objects[i];
+      if (o->ordered || o->ifunc_count == 0)
+	continue;
+
+      const ElfW(Rela) **relocs = &ifunc_relocs[o->ifunc_start];
+      for (size_t j = 0; j < o->ifunc_count; ++j)
+	if (ELFW(R_TYPE) (relocs[j]->r_info) != R_X86_64_IRELATIVE)
+	  relocate_ifunc (o->map, relocs[j]);
+      for (size_t j = 0; j < o->ifunc_count; ++j)
+	if (ELFW(R_TYPE) (relocs[j]->r_info) == R_X86_64_IRELATIVE)
+	  relocate_ifunc (o->map, relocs[j]);
+
+      if (o->relro_size != 0)
+	{
+	  o->map->l_relro_size = o->relro_size;
+	  _dl_protect_relro (o->map);
+	}
+    }
+}
+
+void
+_dl_relocate_parallel (struct link_map *main_map, int reloc_mode)
+{
+  int32_t nthreads = 0;
+#if HAVE_TUNABLES
+  nthreads = TUNABLE_GET (relocation_threads, int32_t, NULL);
+#endif
+  if (nthreads == 0 || GLRO(dl_naudit) > 0 || GLRO(dl_debug_mask) != 0)
+    return;
+
+  /* Put the objects into relocation order and count the IFUNC symbols
+     they export.  The dynamic linker is not relocated here, but other
+     objects can bind to its symbols.  */
+  unsigned int nlist = main_map->l_searchlist.r_nlist;
+  struct object *objects = malloc (nlist * sizeof (*objects));
+  if (objects == NULL)
+    return;
+
+  int nifuncs = add_ifuncs (&GL(dl_rtld_map), NULL);
+  unsigned int count = 0;
+  for (unsigned int i = nlist; i-- > 0 && nifuncs >= 0; )
+    {
+      struct link_map *l = main_map->l_initfini[i];
+      if (l == &GL(dl_rtld_map))
+	continue;
+      int n = add_ifuncs (l, NULL);
+      /* References to the IFUNC symbols of L cannot be recognized if L
+	 has no hash table.  */
+      nifuncs = n < 0 ? n : nifuncs + n;
+      objects[count].map = l;
+      ++count;
+    }
+  if (nifuncs < 0)
+    {
+      free (objects);
+      return;
+    }
+
+  struct ifunc_names names;
+  names.mask = 1;
+  while (names.mask < 2 * (unsigned int) nifuncs)
+    names.mask = names.mask * 2 + 1;
+  names.slots = calloc (names.mask + 1, sizeof (*names.slots));
+  if (names.slots == NULL)
+    {
+      free (objects);
+      return;
+    }
+  add_ifuncs (&GL(dl_rtld_map), &names);
+  for (unsigned int i = 0; i < count; ++i)
+    add_ifuncs (objects[i].map, &names);
+
+  /* Collect the relocations which can call IFUNC resolvers, and
+     determine which objects have to be relocated in order.  */
+  size_t nrelocs = 0;
+  for (unsigned int i = 0; i < count; ++i)
+    {
+      struct object *o = &objects[i];
+      o->ifunc_start = nrelocs;
+      o->ifunc_count = find_ifunc_relocs (o->map, reloc_mode, &names, NULL);
+      o->relro_size = 0;
+      o->ordered = (o->map->l_type == lt_executable
+		    || (o->map->l_info[DT_TEXTREL] != NULL
+			&& o->ifunc_count != 0));
+      nrelocs += o->ifunc_count;
+    }
+  const ElfW(Rela) **ifunc_relocs
+    = malloc ((nrelocs + 1) * sizeof (*ifunc_relocs));
+  if (ifunc_relocs == NULL)
+    {
+      free (names.slots);
+      free (objects);
+      return;
+    }
+  for (unsigned int i = 0; i < count; ++i)
+    find_ifunc_relocs (objects[i].map, reloc_mode, &names,
+		       &ifunc_relocs[objects[i].ifunc_start]);
+  free (names.slots);
+
+  unsigned int longest_run = 0;
+  unsigned int run = 0;
+  for (unsigned int i = 0; i < count; ++i)
+    {
+      run = objects[i].ordered ? 0 : run + 1;
+      if (run > longest_run)
+	longest_run = run;
+    }
+
+  /* More threads than the longest run can keep busy would only
+     wait.  */
+  if (longest_run < 2)
+    nthreads = 0;
+  else if ((unsigned int) nthreads > longest_run - 1)
+    nthreads = longest_run - 1;
+
+  size_t stack_size = ALIGN_UP (HELPER_STACK_SIZE, GLRO(dl_pagesize));
+  char *stacks = MAP_FAILED;
+  if (nthreads > 0)
+    stacks = __mmap (NULL, nthreads * stack_size, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (stacks == MAP_FAILED)
+    {
+      free (ifunc_relocs);
+      free (objects);
+      return;
+    }
+
+  for (unsigned int i = 0; i < count; ++i)
+    {
+      struct object *o = &objects[i];
+      if (!o->ordered && o->ifunc_count != 0)
+	{
+	  o->relro_size = o->map->l_relro_size;
+	  o->map->l_relro_size = 0;
+	}
+    }
+
+  /* After this point, the symbol lookup code must not write to shared
+     data without the lock.  */
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next)
+    l->l_used = 1;
+  void (*saved_lock) (void *) = GL(dl_rtld_lock_recursive);
+  void (*saved_unlock) (void *) = GL(dl_rtld_unlock_recursive);
+  GL(dl_rtld_lock_recursive) = reloc_lock_lock;
+  GL(dl_rtld_unlock_recursive) = reloc_lock_unlock;
+
+  queue.objects = objects;
+  queue.reloc_mode = reloc_mode;
+
+  /* The kernel clears the TID of a helper thread and wakes the futex
+     when the thread has exited and no longer uses its stack.  */
+  pid_t tids[nthreads];
+  int nstarted = 0;
+  for (int i = 0; i < nthreads; ++i)
+    {
+      /* Leave a guard page at the bottom of each stack.  */
+      char *stack = stacks + i * stack_size;
+      __mprotect (stack, GLRO(dl_pagesize), PROT_NONE);
+      /* The stack starts below the thread descriptor.  */
+      struct pthread *pd
+	= (struct pthread *) ALIGN_DOWN ((uintptr_t) stack + stack_size
+					 - TLS_TCB_SIZE, TCB_ALIGNMENT);
+      memcpy (pd, THREAD_SELF, TLS_TCB_SIZE);
+      pd->header.tcb = pd;
+      pd->header.self = pd;
+      if (__clone (helper_thread, pd,
+		   CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND
+		   | CLONE_THREAD | CLONE_SYSVSEM | CLONE_SETTLS
+		   | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID,
+		   (void *) (uintptr_t) (nstarted + 1), &tids[nstarted], pd,
+		   &tids[nstarted]) <= 0)
+	break;
+      ++nstarted;
+    }
+
+  /* The main thread relocates the ordered objects itself, takes part in
+     relocating the runs between them and applies the IFUNC relocations
+     of each run once it is done.  */
+  unsigned int idx = 0;
+  while (idx < count)
+    {
+      if (objects[idx].ordered)
+	{
+	  _dl_relocate_object (objects[idx].map, objects[idx].map->l_scope,
+			       reloc_mode, 0);
+	  ++idx;
+	  /* NEXT has to be updated first, so that no helper thread can
+	     claim an object while it differs from END.  */
+	  atomic_store_relaxed (&queue.next, idx);
+	  atomic_store_release (&queue.end, idx);
+	  continue;
+	}
+
+      unsigned int end = idx + 1;
+      while (end < count && !objects[end].ordered)
+	++end;
+      atomic_store_relaxed (&queue.pending, end - idx);
+      publish (end);
+
+      while (relocate_next (0))
+	;
+      unsigned int pending;
+      while ((pending = atomic_load_acquire (&queue.pending)) != 0)
+	lll_futex_wait (&queue.pending, pending, LLL_PRIVATE);
+      finish_run (objects, idx, end, ifunc_relocs);
+      idx = end;
+    }
+
+  atomic_store_relaxed (&queue.stop, 1);
+  publish (count);
+  for (int i = 0; i < nstarted; ++i)
+    {
+      pid_t tid;
+      while ((tid = atomic_load_acquire (&tids[i])) != 0)
+	lll_futex_wait (&tids[i], tid, LLL_SHARED);
+    }
+
+  GL(dl_rtld_lock_recursive) = saved_lock;
+  GL(dl_rtld_unlock_recursive) = saved_unlock;
+  __munmap (stacks, nthreads * stack_size);
+  free (ifunc_relocs);
+  free (objects);
+}
@@ -476,6 +476,18 @@ long int __x86_raw_shared_cache_size attribute_hidden = 1024 * 1024;
 /* Threshold to use non temporal store.  */
 long int __x86_shared_non_temporal_threshold attribute_hidden;
 
+/* Threshold to use Enhanced REP MOVSB.  */
+long int __x86_rep_movsb_threshold attribute_hidden = 2048;
+
+/* Threshold to stop using Enhanced REP MOVSB.  */
+long int __x86_rep_movsb_stop_threshold attribute_hidden;
+
+/* Threshold to use Enhanced REP STOSB.  */
+long int __x86_rep_stosb_threshold attribute_hidden = 2048;
+
+/* Threshold to use non temporal store in memset.  */
+long int __x86_memset_non_temporal_threshold attribute_hidden;
+
 #ifndef DISABLE_PREFETCHW
 /* PREFETCHW support flag for use in memory and string routines.  */
 int __x86_prefetchw attribute_hidden;
@@ -786,6 +798,48 @@ intel_bug_no_cache_info:
     = (cpu_features->non_temporal_threshold != 0
        ? cpu_features->non_temporal_threshold
        : __x86_shared_cache_size * threads * 3 / 4);
+
+  /* Since there is overhead to set up REP MOVSB operation, REP MOVSB
+     isn't faster on short data.  The memcpy micro benchmark in glibc
+     shows that 2KB is the approximate value above which REP MOVSB
+     becomes faster than SSE2 optimization on processors with Enhanced
+     REP MOVSB.  Since larger register size can move more data with a
+     single load and store, the threshold is higher with larger register
+     size.  memmove-vec-unaligned-erms.S requires the threshold to be
+     greater than 8 times the vector size.  All variants share the
+     threshold, including those which the selector did not pick, so a
+     tunable value has to satisfy this for the largest vector size.  */
+  unsigned int vec_size;
+  if (CPU_FEATURES_ARCH_P (cpu_features, AVX512F_Usable)
+      && !CPU_FEATURES_ARCH_P (cpu_features, Prefer_No_AVX512))
+    vec_size = 64;
+  else if (CPU_FEATURES_ARCH_P (cpu_features, AVX_Fast_Unaligned_Load))
+    vec_size = 32;
+  else
+    vec_size = 16;
+  __x86_rep_movsb_threshold
+    = (cpu_features->rep_movsb_threshold > 64 * 8
+       ? cpu_features->rep_movsb_threshold
+       : 2048 * (vec_size / 16));
+
+  /* The memset micro benchmark in glibc shows that 2KB is the
+     approximate value above which REP STOSB becomes faster on
+     processors with Enhanced REP STOSB.  Since the stored value is
+     fixed, larger register size has minimal impact on threshold.  */
+  if (cpu_features->rep_stosb_threshold != 0)
+    __x86_rep_stosb_threshold = cpu_features->rep_stosb_threshold;
+
+  /* memset switches to non-temporal stores at the same size as memmove
+     by default, so that clearing a buffer much larger than the shared
+     cache doesn't evict everything else from it.  Above the threshold
+     non-temporal stores are also used instead of REP STOSB.  */
+  __x86_memset_non_temporal_threshold
+    = (cpu_features->memset_non_temporal_threshold != 0
+       ? cpu_features->memset_non_temporal_threshold
+       : __x86_shared_non_temporal_threshold);
+
+  /* REP MOVSB is used up to the non temporal threshold.  */
+  __x86_rep_movsb_stop_threshold = __x86_shared_non_temporal_threshold;
 }
 
 #endif
@@ -40,6 +40,8 @@
 #define bit_arch_Use_dl_runtime_resolve_opt	(1 << 20)
 #define bit_arch_Use_dl_runtime_resolve_slow	(1 << 21)
 #define bit_arch_Prefer_No_AVX512		(1 << 22)
+#define bit_arch_AVX512VL_Usable		(1 << 23)
+#define bit_arch_AVX512BW_Usable		(1 << 24)
 
 /* CPUID Feature flags.  */
 
@@ -126,6 +128,8 @@
 # define index_arch_Use_dl_runtime_resolve_opt FEATURE_INDEX_1*FEATURE_SIZE
 # define index_arch_Use_dl_runtime_resolve_slow FEATURE_INDEX_1*FEATURE_SIZE
 # define index_arch_Prefer_No_AVX512	FEATURE_INDEX_1*FEATURE_SIZE
+# define index_arch_AVX512VL_Usable	FEATURE_INDEX_1*FEATURE_SIZE
+# define index_arch_AVX512BW_Usable	FEATURE_INDEX_1*FEATURE_SIZE
 
 
 # if defined (_LIBC) && !IS_IN (nonlib)
@@ -223,6 +227,12 @@ struct cpu_features
   unsigned long int shared_cache_size;
   /* Threshold to use non temporal store.  */
   unsigned long int non_temporal_threshold;
+  /* Threshold to use Enhanced REP MOVSB.  */
+  unsigned long int rep_movsb_threshold;
+  /* Threshold to use Enhanced REP STOSB.  */
+  unsigned long int rep_stosb_threshold;
+  /* Threshold to use non temporal store in memset.  */
+  unsigned long int memset_non_temporal_threshold;
 };
 
 /* Used from outside of glibc to get access to the CPU features
@@ -329,6 +339,8 @@ extern const struct cpu_features *__get_cpu_features (void)
 # define index_arch_Use_dl_runtime_resolve_opt FEATURE_INDEX_1
 # define index_arch_Use_dl_runtime_resolve_slow FEATURE_INDEX_1
 # define index_arch_Prefer_No_AVX512	FEATURE_INDEX_1
+# define index_arch_AVX512VL_Usable	FEATURE_INDEX_1
+# define index_arch_AVX512BW_Usable	FEATURE_INDEX_1
 
 #endif	/* !__ASSEMBLER__ */
 
@@ -0,0 +1,9 @@
+#define MEMMEM __memmem_sse2
+#undef libc_hidden_def
+#define libc_hidden_def(name)
+#undef weak_alias
+#define weak_alias(ignored1, ignored2)
+#undef libc_hidden_weak
+#define libc_hidden_weak(name)
+
+#include "string/memmem.c"
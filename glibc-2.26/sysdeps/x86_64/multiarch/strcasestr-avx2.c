@@ -0,0 +1,3 @@
+#define VEC_SIZE 32
+#define STRCASESTR __strcasestr_avx2
+#include "strstr-vec.h"
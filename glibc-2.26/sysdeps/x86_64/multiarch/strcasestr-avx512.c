@@ -0,0 +1,3 @@
+#define VEC_SIZE 64
+#define STRCASESTR __strcasestr_avx512
+#include "strstr-vec.h"
@@ -0,0 +1,8 @@
+#include <string.h>
+
+#define STRCASESTR __strcasestr_sse2
+#define NO_ALIAS
+
+extern __typeof (__strcasestr) __strcasestr_sse2 attribute_hidden;
+
+#include "string/strcasestr.c"
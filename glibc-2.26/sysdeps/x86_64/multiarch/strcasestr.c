@@ -1,4 +1,4 @@
-/* Common definition for ifunc selections optimized with SSE2 and SSE4.2.
+/* Multiple versions of strcasestr.
    All versions must be listed in ifunc-impl-list.c.
    Copyright (C) 2017 Free Software Foundation, Inc.
    This file is part of the GNU C Library.
@@ -17,18 +17,17 @@
    License along with the GNU C Library; if not, see
    <http://www.gnu.org/licenses/>.  */
 
-#include <init-arch.h>
+/* Define multiple versions only for the definition in libc.  */
+#if IS_IN (libc)
+# define strcasestr __redirect_strcasestr
+# include <string.h>
+# undef strcasestr
 
-extern __typeof (REDIRECT_NAME) OPTIMIZE (sse2) attribute_hidden;
-extern __typeof (REDIRECT_NAME) OPTIMIZE (sse42) attribute_hidden;
+# define SYMBOL_NAME strcasestr
+# include "ifunc-strstr.h"
 
-static inline void *
-IFUNC_SELECTOR (void)
-{
-  const struct cpu_features* cpu_features = __get_cpu_features ();
+libc_ifunc_redirected (__redirect_strcasestr, __strcasestr,
+		       IFUNC_SELECTOR ());
 
-  if (CPU_FEATURES_CPU_P (cpu_features, SSE4_2))
-    return OPTIMIZE (sse42);
-
-  return OPTIMIZE (sse2);
-}
+weak_alias (__strcasestr, strcasestr)
+#endif
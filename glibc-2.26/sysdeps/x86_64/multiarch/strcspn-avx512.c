@@ -0,0 +1,3 @@
+#define VEC_SIZE 64
+#define STRCSPN __strcspn_avx512
+#include "strspn-vec.h"
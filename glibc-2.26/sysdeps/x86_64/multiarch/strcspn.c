@@ -25,7 +25,7 @@
 # undef strcspn
 
 # define SYMBOL_NAME strcspn
-# include "ifunc-sse4_2.h"
+# include "ifunc-strspn.h"
 
 libc_ifunc_redirected (__redirect_strcspn, strcspn, IFUNC_SELECTOR ());
 
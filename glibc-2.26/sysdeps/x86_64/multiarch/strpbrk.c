@@ -25,7 +25,7 @@
 # undef strpbrk
 
 # define SYMBOL_NAME strpbrk
-# include "ifunc-sse4_2.h"
+# include "ifunc-strspn.h"
 
 libc_ifunc_redirected (__redirect_strpbrk, strpbrk, IFUNC_SELECTOR ());
 
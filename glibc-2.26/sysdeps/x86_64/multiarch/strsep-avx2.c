@@ -0,0 +1,3 @@
+#define VEC_SIZE 32
+#define STRSEP __strsep_avx2
+#include "strspn-vec.h"
@@ -0,0 +1,3 @@
+#define VEC_SIZE 64
+#define STRSEP __strsep_avx512
+#include "strspn-vec.h"
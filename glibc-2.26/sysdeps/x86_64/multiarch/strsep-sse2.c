@@ -0,0 +1,8 @@
+#include <string.h>
+
+#define STRSEP __strsep_sse2
+#define NO_ALIAS
+
+extern __typeof (__strsep) __strsep_sse2 attribute_hidden;
+
+#include "string/strsep.c"
@@ -0,0 +1,40 @@
+/* Multiple versions of strsep.
+   All versions must be listed in ifunc-impl-list.c.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* Define multiple versions only for the definition in libc.  */
+#if IS_IN (libc)
+# define __strsep __redirect___strsep
+# define __strsep_g __redirect___strsep_g
+# include <string.h>
+# undef __strsep
+# undef __strsep_g
+
+# define SYMBOL_NAME strsep
+# define STRSPN_NO_SSE42
+# include "ifunc-strspn.h"
+
+libc_ifunc_redirected (__redirect___strsep, __strsep, IFUNC_SELECTOR ());
+
+weak_alias (__strsep, strsep)
+strong_alias (__strsep, __strsep_g)
+# ifdef SHARED
+__hidden_ver1 (__strsep, __GI___strsep_g, __redirect___strsep_g)
+  __attribute__ ((visibility ("hidden")));
+# endif
+#endif
@@ -0,0 +1,3 @@
+#define VEC_SIZE 64
+#define STRSPN __strspn_avx512
+#include "strspn-vec.h"
@@ -0,0 +1,245 @@
+/* strspn/strcspn/strpbrk/strtok_r/strsep with a vectorized byte set.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file is included with VEC_SIZE set to 32 for AVX2 or to 64 for
+   AVX512BW, and with one of STRSPN, STRCSPN, STRPBRK, STRTOK_R or
+   STRSEP defined to the name of the function to build.
+
+   The set of bytes is stored as a bitmap of 256 bits in two vectors
+   of 16 bytes, each repeated in every 128-bit lane.  Byte N of the
+   first vector has bit H set if the byte H * 16 + N is in the set, for
+   H from 0 to 7, and the second vector holds the bits for H from 8 to
+   15.  A vector of the string is classified by looking up its low
+   nibbles in both vectors with a byte shuffle, selecting the result
+   for the high bit of each byte and testing it against the bit for
+   its high nibble, so the size of the set does not matter.  */
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#if VEC_SIZE == 32
+typedef __m256i vec_t;
+typedef uint32_t mask_t;
+# define VEC_LOAD(p)	_mm256_load_si256 ((const __m256i *) (p))
+# define VEC_BROADCAST(p) \
+  _mm256_broadcastsi128_si256 (_mm_load_si128 ((const __m128i *) (p)))
+#elif VEC_SIZE == 64
+typedef __m512i vec_t;
+typedef uint64_t mask_t;
+# define VEC_LOAD(p)	_mm512_load_si512 (p)
+# define VEC_BROADCAST(p) \
+  _mm512_broadcast_i32x4 (_mm_load_si128 ((const __m128i *) (p)))
+#else
+# error "Unsupported VEC_SIZE"
+#endif
+
+struct byte_set
+{
+  vec_t low;
+  vec_t high;
+  vec_t bits;
+};
+
+static const unsigned char bit_table[16] __attribute__ ((aligned (16))) =
+  {
+    1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+  };
+
+/* Initialize SET with the bytes of the string A.  The null byte is
+   never part of the set.  */
+static __always_inline void
+set_init (struct byte_set *set, const char *a)
+{
+  unsigned char rows[2][16] __attribute__ ((aligned (16)));
+
+  memset (rows, 0, sizeof (rows));
+  for (const unsigned char *p = (const unsigned char *) a; *p != '\0'; ++p)
+    rows[*p >> 7][*p & 15] |= 1 << ((*p >> 4) & 7);
+  set->low = VEC_BROADCAST (rows[0]);
+  set->high = VEC_BROADCAST (rows[1]);
+  set->bits = VEC_BROADCAST (bit_table);
+}
+
+/* Return the mask of the bytes of V which are in SET.  If NUL is
+   nonzero, the null byte counts as part of the set.  */
+static __always_inline mask_t
+set_match (const struct byte_set *set, vec_t v, int nul)
+{
+#if VEC_SIZE == 32
+  __m256i nibble = _mm256_set1_epi8 (0x0f);
+  __m256i zero = _mm256_setzero_si256 ();
+  __m256i lo = _mm256_and_si256 (v, nibble);
+  __m256i hi = _mm256_and_si256 (_mm256_srli_epi16 (v, 4), nibble);
+  __m256i row = _mm256_blendv_epi8 (_mm256_shuffle_epi8 (set->low, lo),
+				    _mm256_shuffle_epi8 (set->high, lo), v);
+  __m256i bit = _mm256_shuffle_epi8 (set->bits, hi);
+  __m256i out = _mm256_cmpeq_epi8 (_mm256_and_si256 (row, bit), zero);
+  if (nul)
+    out = _mm256_andnot_si256 (_mm256_cmpeq_epi8 (v, zero), out);
+  return ~(mask_t) _mm256_movemask_epi8 (out);
+#else
+  __m512i nibble = _mm512_set1_epi8 (0x0f);
+  __m512i lo = _mm512_and_si512 (v, nibble);
+  __m512i hi = _mm512_and_si512 (_mm512_srli_epi16 (v, 4), nibble);
+  __m512i row = _mm512_mask_blend_epi8 (_mm512_movepi8_mask (v),
+					_mm512_shuffle_epi8 (set->low, lo),
+					_mm512_shuffle_epi8 (set->high, lo));
+  __m512i bit = _mm512_shuffle_epi8 (set->bits, hi);
+  mask_t m = _mm512_test_epi8_mask (row, bit);
+  if (nul)
+    m |= _mm512_testn_epi8_mask (v, v);
+  return m;
+#endif
+}
+
+/* Return a pointer to the first byte at or after S which is in SET, or
+   the terminating null byte, if IN is nonzero, or to the first byte
+   which is not in SET otherwise.  The string is read with aligned
+   loads, so no load crosses a page boundary.  */
+static __always_inline char *
+set_scan (const struct byte_set *set, const char *s, int in)
+{
+  uintptr_t offset = (uintptr_t) s & (VEC_SIZE - 1);
+  const char *p = s - offset;
+  mask_t m = set_match (set, VEC_LOAD (p), in);
+
+  if (!in)
+    m = ~m;
+  m >>= offset;
+  if (m != 0)
+    return (char *) s + __builtin_ctzll (m);
+
+  for (;;)
+    {
+      p += VEC_SIZE;
+      m = set_match (set, VEC_LOAD (p), in);
+      if (!in)
+	m = ~m;
+      if (m != 0)
+	return (char *) p + __builtin_ctzll (m);
+    }
+}
+
+/* Return a pointer to the first byte of S which is in the string
+   REJECT, or to its terminating null byte.  */
+static __always_inline char *
+cspan (const char *s, const char *reject)
+{
+  if (reject[0] == '\0' || reject[1] == '\0')
+    return __strchrnul (s, reject[0]);
+
+  struct byte_set set;
+  set_init (&set, reject);
+  return set_scan (&set, s, 1);
+}
+
+#ifdef STRSPN
+size_t
+STRSPN (const char *s, const char *accept)
+{
+  if (accept[0] == '\0')
+    return 0;
+
+  struct byte_set set;
+  set_init (&set, accept);
+  return set_scan (&set, s, 0) - s;
+}
+#endif
+
+#ifdef STRCSPN
+size_t
+STRCSPN (const char *s, const char *reject)
+{
+  return cspan (s, reject) - s;
+}
+#endif
+
+#ifdef STRPBRK
+char *
+STRPBRK (const char *s, const char *accept)
+{
+  char *p = cspan (s, accept);
+  return *p != '\0' ? p : NULL;
+}
+#endif
+
+#ifdef STRTOK_R
+/* Unlike the generic version, which calls strspn and strcspn with the
+   same delimiters, the set is only built once.  */
+char *
+STRTOK_R (char *s, const char *delim, char **save_ptr)
+{
+  if (s == NULL)
+    s = *save_ptr;
+
+  if (*s == '\0')
+    {
+      *save_ptr = s;
+      return NULL;
+    }
+
+  struct byte_set set;
+  set_init (&set, delim);
+
+  /* Scan leading delimiters.  */
+  s = set_scan (&set, s, 0);
+  if (*s == '\0')
+    {
+      *save_ptr = s;
+      return NULL;
+    }
+
+  /* Find the end of the token.  */
+  char *end = set_scan (&set, s, 1);
+  if (*end == '\0')
+    {
+      *save_ptr = end;
+      return s;
+    }
+
+  /* Terminate the token and make *SAVE_PTR point past it.  */
+  *end = '\0';
+  *save_ptr = end + 1;
+  return s;
+}
+#endif
+
+#ifdef STRSEP
+char *
+STRSEP (char **stringp, const char *delim)
+{
+  char *begin = *stringp;
+  if (begin == NULL)
+    return NULL;
+
+  /* Find the end of the token.  */
+  char *end = cspan (begin, delim);
+  if (*end != '\0')
+    {
+      /* Terminate the token and set *STRINGP past NUL character.  */
+      *end++ = '\0';
+      *stringp = end;
+    }
+  else
+    /* No more delimiters; this is the last token.  */
+    *stringp = NULL;
+
+  return begin;
+}
+#endif
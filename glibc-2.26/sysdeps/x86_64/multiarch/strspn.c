@@ -25,7 +25,7 @@
 # undef strspn
 
 # define SYMBOL_NAME strspn
-# include "ifunc-sse4_2.h"
+# include "ifunc-strspn.h"
 
 libc_ifunc_redirected (__redirect_strspn, strspn, IFUNC_SELECTOR ());
 
@@ -0,0 +1,3 @@
+#define VEC_SIZE 32
+#define STRSTR __strstr_avx2
+#include "strstr-vec.h"
@@ -0,0 +1,284 @@
+/* memmem/strstr/strcasestr with a vectorized candidate filter.
+   Copyright (C) 2017 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file is included with VEC_SIZE set to 32 for AVX2 or to 64 for
+   AVX512BW, and with one of MEMMEM, STRSTR or STRCASESTR defined to the
+   name of the function to build.
+
+   Every position of the haystack is a candidate for a match if its
+   byte is the first byte of the needle and the byte NEEDLE_LEN - 1
+   positions later is the last byte of the needle.  The candidates are
+   computed for VEC_SIZE positions at a time, from two unaligned loads,
+   and only they are compared with the rest of the needle.  If the
+   comparisons take too long, for example for a haystack and a needle
+   made of the same byte, the search continues with the generic two-way
+   implementation, so that the worst case remains linear.  */
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef STRCASESTR
+# include <ctype.h>
+#endif
+
+#if VEC_SIZE == 32
+typedef __m256i vec_t;
+typedef uint32_t mask_t;
+# define VEC_SET1(c)	_mm256_set1_epi8 (c)
+# define VEC_LOADU(p)	_mm256_loadu_si256 ((const __m256i *) (p))
+# define VEC_EQ(a, b) \
+  ((mask_t) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (a, b)))
+#elif VEC_SIZE == 64
+typedef __m512i vec_t;
+typedef uint64_t mask_t;
+# define VEC_SET1(c)	_mm512_set1_epi8 (c)
+# define VEC_LOADU(p)	_mm512_loadu_si512 (p)
+# define VEC_EQ(a, b)	((mask_t) _mm512_cmpeq_epi8_mask (a, b))
+#else
+# error "Unsupported VEC_SIZE"
+#endif
+
+#define PAGE_SIZE 4096
+
+/* Number of needle bytes which may be compared for free, and for each
+   byte of the haystack which has been searched, before the search
+   falls back to the two-way algorithm.  */
+#define VERIFY_ALLOWANCE	2048
+#define VERIFY_PER_BYTE		4
+
+#ifdef MEMMEM
+extern __typeof (__memmem) __memmem_sse2 attribute_hidden;
+
+void *
+MEMMEM (const void *haystack, size_t hs_len, const void *needle,
+	size_t ne_len)
+{
+  const unsigned char *hs = (const unsigned char *) haystack;
+  const unsigned char *ne = (const unsigned char *) needle;
+
+  if (ne_len == 0)
+    return (void *) hs;
+  if (ne_len == 1)
+    return memchr (hs, ne[0], hs_len);
+  if (hs_len < ne_len)
+    return NULL;
+
+  size_t last = ne_len - 1;
+  /* Number of positions at which the needle may start.  */
+  size_t end = hs_len - last;
+  vec_t first_v = VEC_SET1 (ne[0]);
+  vec_t last_v = VEC_SET1 (ne[last]);
+  size_t budget = VERIFY_ALLOWANCE;
+  size_t i = 0;
+
+  for (; i + VEC_SIZE <= end; i += VEC_SIZE)
+    {
+      mask_t m = (VEC_EQ (VEC_LOADU (hs + i), first_v)
+		  & VEC_EQ (VEC_LOADU (hs + i + last), last_v));
+      while (m != 0)
+	{
+	  size_t p = i + __builtin_ctzll (m);
+	  if (memcmp (hs + p + 1, ne + 1, last - 1) == 0)
+	    return (void *) (hs + p);
+	  if (budget < ne_len)
+	    return __memmem_sse2 (hs + p + 1, hs_len - p - 1, ne, ne_len);
+	  budget -= ne_len;
+	  m &= m - 1;
+	}
+      budget += VEC_SIZE * VERIFY_PER_BYTE;
+    }
+
+  if (i == end)
+    return NULL;
+
+  if (end >= VEC_SIZE)
+    {
+      /* Check the last VEC_SIZE positions, ignoring those which have
+	 been checked already.  */
+      size_t j = end - VEC_SIZE;
+      mask_t m = (VEC_EQ (VEC_LOADU (hs + j), first_v)
+		  & VEC_EQ (VEC_LOADU (hs + j + last), last_v));
+      m &= (mask_t) -1 << (i - j);
+      for (; m != 0; m &= m - 1)
+	{
+	  size_t p = j + __builtin_ctzll (m);
+	  if (memcmp (hs + p + 1, ne + 1, last - 1) == 0)
+	    return (void *) (hs + p);
+	}
+      return NULL;
+    }
+
+  /* The haystack is too short for a vector load.  */
+  for (; i < end; ++i)
+    if (hs[i] == ne[0] && hs[i + last] == ne[last]
+	&& memcmp (hs + i + 1, ne + 1, last - 1) == 0)
+      return (void *) (hs + i);
+  return NULL;
+}
+
+#else /* STRSTR || STRCASESTR */
+
+# ifdef STRCASESTR
+extern __typeof (__strcasestr) __strcasestr_sse2 attribute_hidden;
+#  define FUNC		STRCASESTR
+#  define GENERIC	__strcasestr_sse2
+
+/* Store in SET the bytes whose lowercase form in the table TAB is the
+   same as that of C.  Return their number, or -1 if there are more than
+   two of them or one of them is the null byte.  */
+static int
+case_set (const int32_t *tab, unsigned char c, unsigned char set[2])
+{
+  __m256i lower = _mm256_set1_epi32 (tab[c]);
+  int n = 0;
+
+  for (int i = 0; i < 256; i += 8)
+    {
+      __m256i t = _mm256_loadu_si256 ((const __m256i *) (tab + i));
+      unsigned int bits = _mm256_movemask_ps
+	(_mm256_castsi256_ps (_mm256_cmpeq_epi32 (t, lower)));
+      for (; bits != 0; bits &= bits - 1)
+	{
+	  int b = i + __builtin_ctz (bits);
+	  if (n == 2 || b == 0)
+	    return -1;
+	  set[n++] = b;
+	}
+    }
+  if (n == 1)
+    set[1] = set[0];
+  return n;
+}
+
+/* Compare the LEN bytes at S1 and S2 using the lowercase table TAB.  */
+static int
+verify (const int32_t *tab, const unsigned char *s1,
+	const unsigned char *s2, size_t len)
+{
+  for (size_t i = 0; i < len; ++i)
+    if (tab[s1[i]] != tab[s2[i]])
+      return 1;
+  return 0;
+}
+
+#  define MATCH(v, c0, c1)	(VEC_EQ (v, c0) | VEC_EQ (v, c1))
+#  define VERIFY(s1, s2, len)	verify (tab, s1, s2, len)
+#  define BYTE_MATCH(b, c0, c1)	((b) == (c0) || (b) == (c1))
+# else
+extern __typeof (strstr) __strstr_sse2 attribute_hidden;
+#  define FUNC		STRSTR
+#  define GENERIC	__strstr_sse2
+#  define MATCH(v, c0, c1)	VEC_EQ (v, c0)
+#  define VERIFY(s1, s2, len)	memcmp (s1, s2, len)
+#  define BYTE_MATCH(b, c0, c1)	((b) == (c0))
+# endif
+
+char *
+FUNC (const char *haystack, const char *needle)
+{
+  const unsigned char *hs = (const unsigned char *) haystack;
+  const unsigned char *ne = (const unsigned char *) needle;
+  unsigned char first[2], lastc[2];
+
+  if (ne[0] == '\0')
+    return (char *) haystack;
+
+# ifdef STRCASESTR
+  const int32_t *tab = *__ctype_tolower_loc ();
+  if (case_set (tab, ne[0], first) < 0)
+    return GENERIC (haystack, needle);
+# else
+  if (ne[1] == '\0')
+    return strchr (haystack, ne[0]);
+  first[0] = first[1] = ne[0];
+# endif
+
+  size_t ne_len = strlen (needle);
+  size_t last = ne_len - 1;
+  /* Number of bytes between the first and the last byte.  */
+  size_t middle = last != 0 ? last - 1 : 0;
+  /* The haystack must be at least as long as the needle.  This also
+     makes the byte at LAST readable.  */
+  if (__strnlen (haystack, ne_len) < ne_len)
+    return NULL;
+
+# ifdef STRCASESTR
+  if (case_set (tab, ne[last], lastc) < 0)
+    return GENERIC (haystack, needle);
+# else
+  lastc[0] = lastc[1] = ne[last];
+# endif
+
+  vec_t first0 = VEC_SET1 (first[0]);
+  vec_t last0 = VEC_SET1 (lastc[0]);
+# ifdef STRCASESTR
+  vec_t first1 = VEC_SET1 (first[1]);
+  vec_t last1 = VEC_SET1 (lastc[1]);
+# endif
+  vec_t zero = VEC_SET1 (0);
+  size_t budget = VERIFY_ALLOWANCE;
+
+  /* The load at B covers the last bytes of the candidates at P.  It is
+     safe if it does not cross a page, since the byte at B is part of
+     the string or its terminator, and then the load at P is safe as
+     well.  */
+  for (const unsigned char *p = hs;; p += VEC_SIZE)
+    {
+      const unsigned char *b = p + last;
+
+      if (__glibc_unlikely (((uintptr_t) b & (PAGE_SIZE - 1))
+			    > PAGE_SIZE - VEC_SIZE))
+	{
+	  size_t len = __strnlen ((const char *) b, VEC_SIZE);
+	  if (len < VEC_SIZE)
+	    {
+	      /* The string ends within the vector at B, only the first
+		 LEN positions at P remain.  */
+	      for (size_t i = 0; i < len; ++i)
+		if (BYTE_MATCH (p[i], first[0], first[1])
+		    && BYTE_MATCH (b[i], lastc[0], lastc[1])
+		    && VERIFY (p + i + 1, ne + 1, middle) == 0)
+		  return (char *) (p + i);
+	      return NULL;
+	    }
+	}
+
+      vec_t bv = VEC_LOADU (b);
+      mask_t m = (MATCH (VEC_LOADU (p), first0, first1)
+		  & MATCH (bv, last0, last1));
+      mask_t nul = VEC_EQ (bv, zero);
+      if (nul != 0)
+	/* Only the positions before the terminator are candidates.  */
+	m &= (nul & -nul) - 1;
+
+      for (; m != 0; m &= m - 1)
+	{
+	  const unsigned char *c = p + __builtin_ctzll (m);
+	  if (VERIFY (c + 1, ne + 1, middle) == 0)
+	    return (char *) c;
+	  if (budget < ne_len)
+	    return GENERIC ((const char *) c + 1, needle);
+	  budget -= ne_len;
+	}
+
+      if (nul != 0)
+	return NULL;
+      budget += VEC_SIZE * VERIFY_PER_BYTE;
+    }
+}
+#endif
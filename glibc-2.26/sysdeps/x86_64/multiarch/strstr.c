@@ -35,6 +35,8 @@
 
 extern __typeof (__redirect_strstr) __strstr_sse2_unaligned attribute_hidden;
 extern __typeof (__redirect_strstr) __strstr_sse2 attribute_hidden;
+extern __typeof (__redirect_strstr) __strstr_avx2 attribute_hidden;
+extern __typeof (__redirect_strstr) __strstr_avx512 attribute_hidden;
 
 #include "init-arch.h"
 
@@ -42,7 +44,14 @@ extern __typeof (__redirect_strstr) __strstr_sse2 attribute_hidden;
    ifunc symbol properly.  */
 extern __typeof (__redirect_strstr) __libc_strstr;
 libc_ifunc (__libc_strstr,
-	    HAS_ARCH_FEATURE (Fast_Unaligned_Load)
+	    (HAS_ARCH_FEATURE (AVX512BW_Usable)
+	     && !HAS_ARCH_FEATURE (Prefer_No_AVX512))
+	    ? __strstr_avx512
+	    : (HAS_ARCH_FEATURE (AVX2_Usable)
+	       && HAS_ARCH_FEATURE (AVX_Fast_Unaligned_Load)
+	       && !HAS_ARCH_FEATURE (Prefer_No_VZEROUPPER))
+	    ? __strstr_avx2
+	    : HAS_ARCH_FEATURE (Fast_Unaligned_Load)
 	    ? __strstr_sse2_unaligned
 	    : __strstr_sse2)
 
@@ -0,0 +1,3 @@
+#define VEC_SIZE 32
+#define STRTOK_R __strtok_r_avx2
+#include "strspn-vec.h"
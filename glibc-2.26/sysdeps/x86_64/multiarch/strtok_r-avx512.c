@@ -0,0 +1,3 @@
+#define VEC_SIZE 64
+#define STRTOK_R __strtok_r_avx512
+#include "strspn-vec.h"
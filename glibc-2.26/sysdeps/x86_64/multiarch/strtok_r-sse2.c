@@ -0,0 +1,8 @@
+#include <string.h>
+
+#define STRTOK_R __strtok_r_sse2
+#define NO_ALIAS
+
+extern __typeof (__strtok_r) __strtok_r_sse2 attribute_hidden;
+
+#include "string/strtok_r.c"